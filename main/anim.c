@@ -0,0 +1,92 @@
+#include "anim.h"
+
+#include <math.h>
+#include <stdbool.h>
+
+#include "esp_timer.h"
+
+static float sin_table[ANIM_SIN_TABLE_SIZE + 1];
+static bool sin_table_ready = false;
+
+static void sin_table_init(void) {
+  for (int i = 0; i <= ANIM_SIN_TABLE_SIZE; i++)
+    sin_table[i] = sinf(i * 2 * M_PI / ANIM_SIN_TABLE_SIZE);
+  sin_table_ready = true;
+}
+
+void anim_clock_init(anim_clock_t *clock, anim_now_fn_t now_us) {
+  if (!sin_table_ready) sin_table_init();
+  clock->now_us = now_us ? now_us : esp_timer_get_time;
+  clock->start_us = clock->now_us();
+  clock->t_us = 0;
+}
+
+int64_t anim_clock_update(anim_clock_t *clock) {
+  clock->t_us = clock->now_us() - clock->start_us;
+  return clock->t_us;
+}
+
+bam_t anim_rad_to_bam(float rad) {
+  return (bam_t)(int64_t)llroundf(rad / BAM_TO_RAD);
+}
+
+int64_t anim_rad_per_s_to_rate(float rad_per_s) {
+  // float로는 초당 수십억 BAM을 정확히 표현하지 못해 double로 환산
+  return llround(rad_per_s * (4294967296.0 / (2 * M_PI)));
+}
+
+void anim_spin_init(anim_spin_t *spin, float rx, float ry, float rz) {
+  spin->phase[0] = spin->phase[1] = spin->phase[2] = 0;
+  spin->rate[0] = anim_rad_per_s_to_rate(rx);
+  spin->rate[1] = anim_rad_per_s_to_rate(ry);
+  spin->rate[2] = anim_rad_per_s_to_rate(rz);
+}
+
+void anim_spin_eval(const anim_spin_t *spin, int64_t t_us, bam_t out[3]) {
+  // 초 단위 부분은 정수 곱셈(mod 2^32)이라 아무리 오래 돌아도 오차가 쌓이지 않음
+  int64_t sec = t_us / 1000000;
+  int64_t rem = t_us % 1000000;
+  for (int i = 0; i < 3; i++) {
+    out[i] = spin->phase[i] + (bam_t)((uint64_t)spin->rate[i] * (uint64_t)sec) +
+             (bam_t)(spin->rate[i] * rem / 1000000);
+  }
+}
+
+float anim_sin(bam_t angle) {
+  uint32_t idx = angle >> (32 - ANIM_SIN_TABLE_BITS);
+  float frac = (float)(angle << ANIM_SIN_TABLE_BITS) * (1.0f / 4294967296.0f);
+  return sin_table[idx] + (sin_table[idx + 1] - sin_table[idx]) * frac;
+}
+
+float anim_cos(bam_t angle) { return anim_sin(angle + 0x40000000u); }
+
+void anim_track_build(anim_track_t *track, const anim_key_t *keys,
+                      uint16_t key_count, uint16_t samples, int64_t period_us) {
+  if (samples > ANIM_TRACK_MAX_SAMPLES) samples = ANIM_TRACK_MAX_SAMPLES;
+  track->count = samples;
+  track->period_us = period_us;
+
+  int k = 0;
+  for (int i = 0; i < samples; i++) {
+    float t = (float)i / samples;
+    while (k + 1 < key_count && keys[k + 1].time <= t) k++;
+    const anim_key_t *a = &keys[k];
+    // 마지막 키 다음은 첫 키로 되돌아감 (주기 반복)
+    const anim_key_t *b = k + 1 < key_count ? &keys[k + 1] : &keys[0];
+    float span = (k + 1 < key_count ? b->time : 1.0f + b->time) - a->time;
+    float u = span > 0 ? (t - a->time) / span : 0;
+    u = u * u * (3 - 2 * u);  // smoothstep
+    track->samples[i] = a->value + (b->value - a->value) * u;
+  }
+  track->samples[samples] = track->samples[0];
+}
+
+float anim_track_eval(const anim_track_t *track, int64_t t_us) {
+  int64_t phase = t_us % track->period_us;
+  // 16.16 고정소수점 샘플 위치
+  int64_t pos = (phase * track->count << 16) / track->period_us;
+  int idx = pos >> 16;
+  float frac = (pos & 0xffff) * (1.0f / 65536.0f);
+  return track->samples[idx] +
+         (track->samples[idx + 1] - track->samples[idx]) * frac;
+}
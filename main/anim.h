@@ -0,0 +1,62 @@
+#ifndef __ANIM_H__
+#define __ANIM_H__
+
+#include <stdint.h>
+
+/*
+ * time based animation. everything is evaluated from an absolute monotonic
+ * time instead of being accumulated per frame, so frames can be skipped or
+ * rendered at any rate without changing the motion. the clock source can be
+ * swapped (e.g. a simulated clock on the host) for deterministic playback.
+ */
+
+// binary angle: a full turn is 2^32, so wraparound is free and exact
+typedef uint32_t bam_t;
+
+#define BAM_TO_RAD (6.283185307179586f / 4294967296.0f)
+#define ANIM_SIN_TABLE_BITS 10
+#define ANIM_SIN_TABLE_SIZE (1 << ANIM_SIN_TABLE_BITS)
+#define ANIM_TRACK_MAX_SAMPLES 64
+
+typedef int64_t (*anim_now_fn_t)(void);
+
+typedef struct {
+  anim_now_fn_t now_us;  // NULL: esp_timer_get_time
+  int64_t start_us;
+  int64_t t_us;  // animation time of the current frame
+} anim_clock_t;
+
+// constant angular velocity per axis
+typedef struct {
+  bam_t phase[3];
+  int64_t rate[3];  // BAM per second
+} anim_spin_t;
+
+typedef struct {
+  float time;  // 0..1 within the period
+  float value;
+} anim_key_t;
+
+// periodic keyframe curve resampled into a uniform table at build time
+typedef struct {
+  float samples[ANIM_TRACK_MAX_SAMPLES + 1];
+  uint16_t count;
+  int64_t period_us;
+} anim_track_t;
+
+void anim_clock_init(anim_clock_t *clock, anim_now_fn_t now_us);
+int64_t anim_clock_update(anim_clock_t *clock);
+
+bam_t anim_rad_to_bam(float rad);
+int64_t anim_rad_per_s_to_rate(float rad_per_s);
+void anim_spin_init(anim_spin_t *spin, float rx, float ry, float rz);
+void anim_spin_eval(const anim_spin_t *spin, int64_t t_us, bam_t out[3]);
+
+float anim_sin(bam_t angle);
+float anim_cos(bam_t angle);
+
+void anim_track_build(anim_track_t *track, const anim_key_t *keys,
+                      uint16_t key_count, uint16_t samples, int64_t period_us);
+float anim_track_eval(const anim_track_t *track, int64_t t_us);
+
+#endif  // __ANIM_H__
@@ -0,0 +1,252 @@
+#include "bench.h"
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "camera.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "heap_tag.h"
+#include "raster.h"
+#include "render.h"
+#include "sdkconfig.h"
+#include "xform.h"
+
+#define TAG "BENCH"
+#define CHECK_ALLOC(ptr)                                    \
+  do {                                                      \
+    if (ptr == NULL) {                                      \
+      ESP_LOGE(TAG, "Failed to allocate memory: %s", #ptr); \
+      abort();                                              \
+    }                                                       \
+  } while (0)
+
+#define BENCH_MAX_MESHES 5
+#define BENCH_MAX_INSTANCES (BENCH_GRID * BENCH_GRID)
+
+typedef struct {
+  object3d_t *mesh;
+  mat34_t mvp;
+  int16_t *xy;  // projected by BENCH_PROJECT
+} bench_instance_t;
+
+typedef struct {
+  const char *name;
+  bench_instance_t instances[BENCH_MAX_INSTANCES];
+  uint32_t instance_count;
+  uint32_t vertices;  // over all instances
+  uint32_t edges;
+} bench_scene_t;
+
+static const char *const kernel_names[BENCH_KERNEL_COUNT] = {
+    "project", "edges", "flush", "frame"};
+
+// BENCH_FRAME가 render_frame을 부를 때마다 한 프레임 주기씩 나아가는 시계
+static int64_t bench_now_us;
+
+static int64_t bench_clock(void) { return bench_now_us; }
+
+static void instance_add(bench_scene_t *scene, const camera_t *cam,
+                         object3d_t *mesh, vec3_t pos, float scale,
+                         float angle) {
+  bench_instance_t *inst = &scene->instances[scene->instance_count++];
+  float s = sinf(angle), c = cosf(angle);
+  mat3_t r = mat3_from_euler(s, c, s, c, 0, 1);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) r.m[i][j] *= scale;
+  mat34_t model = mat34_from_rt(&r, pos);
+  inst->mesh = mesh;
+  inst->mvp = mat34_mul(&cam->view_proj, &model);
+  inst->xy = heap_tag_malloc(HEAP_TAG_RENDER,
+                             mesh->verts.count * 2 * sizeof(int16_t),
+                             MALLOC_CAP_8BIT);
+  CHECK_ALLOC(inst->xy);
+  scene->vertices += mesh->verts.count;
+  scene->edges += mesh->edge_count;
+}
+
+static void bench_project(bench_scene_t *scene) {
+  for (uint32_t i = 0; i < scene->instance_count; i++) {
+    bench_instance_t *inst = &scene->instances[i];
+    const vertex_soa_t *v = &inst->mesh->verts;
+    xform_project(&inst->mvp, v->x, v->y, v->z, v->count, CAMERA_NEAR,
+                  inst->xy);
+  }
+}
+
+static void bench_edges(bench_scene_t *scene, render_data_t *data,
+                        uint8_t *fb) {
+  for (uint32_t i = 0; i < scene->instance_count; i++) {
+    bench_instance_t *inst = &scene->instances[i];
+    render_draw_edges(fb, data, inst->mesh, inst->xy);
+  }
+}
+
+static void bench_call(bench_kernel_t kernel, bench_scene_t *scene,
+                       render_data_t *data, uint8_t *fb, uint8_t *pages) {
+  switch (kernel) {
+    case BENCH_PROJECT:
+      bench_project(scene);
+      break;
+    case BENCH_EDGES:
+      bench_edges(scene, data, fb);
+      break;
+    case BENCH_FLUSH:
+      raster_to_pages(fb, pages, 0, 0, LCD_WIDTH - 1, LCD_HEIGHT - 1);
+      break;
+    default:
+      bench_now_us += atomic_load(&data->sched->period_us);
+      render_frame(data);
+      break;
+  }
+}
+
+static uint32_t bench_once(bench_kernel_t kernel, bench_scene_t *scene,
+                           render_data_t *data, uint8_t *fb, uint8_t *pages) {
+  // 선분은 이미 켜진 픽셀 위에 다시 그려도 같은 일을 하므로 지우지 않음
+  uint32_t start = esp_cpu_get_cycle_count();
+  for (int i = 0; i < BENCH_REPEAT; i++)
+    bench_call(kernel, scene, data, fb, pages);
+  return (esp_cpu_get_cycle_count() - start) / BENCH_REPEAT;
+}
+
+static int cmp_u32(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+static bench_result_t bench_kernel(bench_kernel_t kernel,
+                                   bench_scene_t *scene, render_data_t *data,
+                                   uint8_t *fb, uint8_t *pages) {
+  uint32_t cycles[BENCH_RUNS];
+  uint64_t total = 0;
+  bench_once(kernel, scene, data, fb, pages);  // 캐시와 분기 예측을 데움
+  for (int i = 0; i < BENCH_RUNS; i++) {
+    cycles[i] = bench_once(kernel, scene, data, fb, pages);
+    total += cycles[i];
+  }
+  qsort(cycles, BENCH_RUNS, sizeof(cycles[0]), cmp_u32);
+  bench_result_t r = {
+      .min = cycles[0],
+      .median = cycles[BENCH_RUNS / 2],
+      .mean = total / BENCH_RUNS,
+      .max = cycles[BENCH_RUNS - 1],
+  };
+  switch (kernel) {
+    case BENCH_PROJECT:
+      r.items = scene->vertices;
+      break;
+    case BENCH_EDGES:
+      r.items = scene->edges;
+      break;
+    default:
+      r.items = LCD_WIDTH * LCD_HEIGHT;
+      break;
+  }
+  return r;
+}
+
+static void scene_free(bench_scene_t *scene) {
+  for (uint32_t i = 0; i < scene->instance_count; i++)
+    heap_tag_free(HEAP_TAG_RENDER, scene->instances[i].xy);
+}
+
+static void print_result(FILE *out, bool first, const char *scene,
+                         bench_kernel_t kernel, const bench_result_t *r) {
+  fprintf(out,
+          "%s{\"scene\":\"%s\",\"kernel\":\"%s\",\"items\":%lu,"
+          "\"min\":%lu,\"median\":%lu,\"mean\":%lu,\"max\":%lu}",
+          first ? "" : ",", scene, kernel_names[kernel],
+          (unsigned long)r->items, (unsigned long)r->min,
+          (unsigned long)r->median, (unsigned long)r->mean,
+          (unsigned long)r->max);
+}
+
+// render_task가 처음 보고할 때 벤치마크 프레임이 섞이지 않게 함
+static void render_data_restore(render_data_t *data) {
+  anim_clock_init(&data->clock, NULL);
+  data->proj_hits = data->proj_misses = 0;
+  data->edges_drawn = data->edges_total = 0;
+  data->impostor_us = data->live_us = 0;
+  data->impostor_draws = data->live_draws = 0;
+  data->points_us = 0;
+}
+
+void bench_run_all(FILE *out, const char *target, render_data_t *data) {
+  enum { CUBE, CONE, CYLINDER, SPHERE, HIGHPOLY };
+  object3d_t *meshes = heap_tag_calloc(HEAP_TAG_RENDER, BENCH_MAX_MESHES,
+                                       sizeof(object3d_t), MALLOC_CAP_8BIT);
+  CHECK_ALLOC(meshes);
+  // 장면 커널의 선분은 숨은 선 판정 없이 RENDER_WIREFRAME으로 그림
+  render_data_t *wireframe = heap_tag_calloc(HEAP_TAG_RENDER, 1,
+                                             sizeof(render_data_t),
+                                             MALLOC_CAP_8BIT);
+  CHECK_ALLOC(wireframe);
+  wireframe->render_mode = RENDER_WIREFRAME;
+  object3d_cube_init(&meshes[CUBE]);
+  object3d_cone_init(&meshes[CONE]);
+  object3d_cylinder_init(&meshes[CYLINDER]);
+  object3d_sphere_init(&meshes[SPHERE], SPHERE_LATITUDE_COUNT,
+                       SPHERE_LONGITUDE_COUNT);
+  object3d_sphere_init(&meshes[HIGHPOLY], BENCH_HIGHPOLY_LATITUDES,
+                       BENCH_HIGHPOLY_LONGITUDES);
+
+  camera_t cam;
+  camera_init(&cam, LCD_WIDTH, LCD_HEIGHT, FOV);
+  camera_set_pos(&cam, (vec3_t){0, 0, -8});
+  camera_look_at(&cam, (vec3_t){0, 0, 0});
+  camera_update(&cam);
+
+  static bench_scene_t scenes[3];
+  memset(scenes, 0, sizeof(scenes));
+  scenes[0].name = "primitives";
+  scenes[1].name = "instances_100";
+  scenes[2].name = "highpoly";
+  for (int i = 0; i < 4; i++)
+    instance_add(&scenes[0], &cam, &meshes[i],
+                 (vec3_t){-4 + i * 8.0f / 3, 0, 0}, 1, 0.3f + i * 0.2f);
+  for (int i = 0; i < BENCH_MAX_INSTANCES; i++)
+    instance_add(&scenes[1], &cam, &meshes[i % 4],
+                 (vec3_t){(i % BENCH_GRID - 4.5f) * 1.1f,
+                          (i / BENCH_GRID - 4.5f) * 0.6f, 0},
+                 0.25f, i * 0.1f);
+  instance_add(&scenes[2], &cam, &meshes[HIGHPOLY], (vec3_t){0, 0, 0},
+               BENCH_HIGHPOLY_RADIUS, 0.4f);
+
+  uint8_t *fb = heap_tag_calloc(HEAP_TAG_RENDER, LCD_BUF_SIZE, 1,
+                                MALLOC_CAP_8BIT);
+  uint8_t *pages = heap_tag_calloc(HEAP_TAG_RENDER, LCD_BUF_SIZE, 1,
+                                   MALLOC_CAP_8BIT);
+  CHECK_ALLOC(fb);
+  CHECK_ALLOC(pages);
+
+  fprintf(out, "{\"bench\":1,\"target\":\"%s\",\"cpu_mhz\":%d,\"runs\":%d,"
+          "\"repeat\":%d,\"results\":[", target,
+          CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ, BENCH_RUNS, BENCH_REPEAT);
+  for (int s = 0; s < 3; s++) {
+    for (int k = 0; k < BENCH_FRAME; k++) {
+      bench_result_t r = bench_kernel(k, &scenes[s], wireframe, fb, pages);
+      print_result(out, s == 0 && k == 0, scenes[s].name, k, &r);
+      // 긴 측정 사이에 IDLE 태스크가 돌아 task watchdog이 울리지 않게 함
+      vTaskDelay(1);
+    }
+    scene_free(&scenes[s]);
+  }
+  bench_now_us = 0;
+  anim_clock_init(&data->clock, bench_clock);
+  bench_result_t r = bench_kernel(BENCH_FRAME, NULL, data, fb, pages);
+  print_result(out, false, "render", BENCH_FRAME, &r);
+  render_data_restore(data);
+  fprintf(out, "]}\n");
+  fflush(out);
+
+  heap_tag_free(HEAP_TAG_RENDER, fb);
+  heap_tag_free(HEAP_TAG_RENDER, pages);
+  heap_tag_free(HEAP_TAG_RENDER, wireframe);
+  for (int i = 0; i < BENCH_MAX_MESHES; i++) object3d_free(&meshes[i]);
+  heap_tag_free(HEAP_TAG_RENDER, meshes);
+}
@@ -0,0 +1,49 @@
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "render.h"
+
+/*
+ * render kernel benchmarks, the same code on the device (boot with
+ * BENCH_BOOT_GPIO pulled low) and on the host (tools/sim wireframe_bench).
+ * the scenes instance render.c's own meshes and draw them with its edge
+ * loop; the frame kernel is render_frame on the app's render data, run on
+ * a clock that advances one frame period per call. every kernel runs
+ * BENCH_RUNS times and the result is printed as one JSON line starting
+ * with {"bench": for tools/bench_compare.py. cycles come from
+ * esp_cpu_get_cycle_count, the host shim scales the monotonic clock to the
+ * configured CPU frequency.
+ */
+
+#define BENCH_RUNS 21
+#define BENCH_REPEAT 8  // calls per sample, the sample is their average
+#define BENCH_BOOT_GPIO GPIO_NUM_4  // low at reset runs the benchmarks
+#define BENCH_GRID 10               // instances scene is GRID x GRID
+#define BENCH_HIGHPOLY_LATITUDES 32
+#define BENCH_HIGHPOLY_LONGITUDES 64
+#define BENCH_HIGHPOLY_RADIUS 2.5f
+
+typedef enum {
+  BENCH_PROJECT,  // xform_project of every instance
+  BENCH_EDGES,    // render_draw_edges over projected instances
+  BENCH_FLUSH,    // raster_to_pages of the whole frame (lvgl_flush_cb)
+  BENCH_FRAME,    // render_frame, only in the "render" scene
+  BENCH_KERNEL_COUNT,
+} bench_kernel_t;
+
+typedef struct {
+  uint32_t min;
+  uint32_t median;
+  uint32_t mean;
+  uint32_t max;
+  uint32_t items;  // vertices, edges or pixels handled per run
+} bench_result_t;
+
+// data: from setup_render_data, its clock and counters are reset afterwards
+void bench_run_all(FILE *out, const char *target, render_data_t *data);
+
+#endif  // __BENCH_H__
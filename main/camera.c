@@ -0,0 +1,60 @@
+#include "camera.h"
+
+#include <math.h>
+
+void camera_init(camera_t *cam, uint16_t width, uint16_t height,
+                 float fov_deg) {
+  recip_table_init();
+  cam->pos = (vec3_t){0, 0, 0};
+  cam->target = (vec3_t){0, 0, 1};
+  cam->up = (vec3_t){0, 1, 0};
+  cam->fov_deg = fov_deg;
+  cam->width = width;
+  cam->height = height;
+  cam->version = 0;
+  cam->dirty = true;
+}
+
+void camera_set_pos(camera_t *cam, vec3_t pos) {
+  cam->pos = pos;
+  cam->dirty = true;
+}
+
+void camera_look_at(camera_t *cam, vec3_t target) {
+  cam->target = target;
+  cam->dirty = true;
+}
+
+void camera_set_fov(camera_t *cam, float fov_deg) {
+  cam->fov_deg = fov_deg;
+  cam->dirty = true;
+}
+
+bool camera_update(camera_t *cam) {
+  if (!cam->dirty) return false;
+
+  // 카메라 좌표계: +z가 바라보는 방향, +y가 위
+  vec3_t f = vec3_normalize(vec3_sub(cam->target, cam->pos));
+  vec3_t r = vec3_normalize(vec3_cross(cam->up, f));
+  vec3_t u = vec3_cross(f, r);
+  cam->view = (mat34_t){{
+      {r.x, r.y, r.z, -vec3_dot(r, cam->pos)},
+      {u.x, u.y, u.z, -vec3_dot(u, cam->pos)},
+      {f.x, f.y, f.z, -vec3_dot(f, cam->pos)},
+  }};
+
+  // fov가 클수록 focal이 짧아져 물체가 작게 보임
+  cam->focal = (cam->width / 2) / tanf(cam->fov_deg * 0.5f * (M_PI / 180.0f));
+  float cx = cam->width / 2;
+  float cy = cam->height / 2;
+  mat34_t proj = {{
+      {cam->focal, 0, cx, 0},
+      {0, -cam->focal, cy, 0},
+      {0, 0, 1, 0},
+  }};
+  cam->view_proj = mat34_mul(&proj, &cam->view);
+
+  cam->version++;
+  cam->dirty = false;
+  return true;
+}
@@ -0,0 +1,37 @@
+#ifndef __CAMERA_H__
+#define __CAMERA_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "math3d.h"
+
+#define CAMERA_NEAR 0.1f
+
+/*
+ * look-at camera with a pinhole projection. the view-projection matrix maps
+ * world space to (x * w, y * w, w) in screen pixels and is only rebuilt when
+ * one of the setters marked the camera dirty; `version` changes on every
+ * rebuild so per-object caches can tell when it moved.
+ */
+typedef struct {
+  vec3_t pos;
+  vec3_t target;
+  vec3_t up;
+  float fov_deg;  // horizontal, the vertical fov follows from width / height
+  uint16_t width;
+  uint16_t height;
+  float focal;  // pixels, same on both axes since the pixels are square
+  mat34_t view;
+  mat34_t view_proj;
+  uint32_t version;
+  bool dirty;
+} camera_t;
+
+void camera_init(camera_t *cam, uint16_t width, uint16_t height, float fov_deg);
+void camera_set_pos(camera_t *cam, vec3_t pos);
+void camera_look_at(camera_t *cam, vec3_t target);
+void camera_set_fov(camera_t *cam, float fov_deg);
+bool camera_update(camera_t *cam);
+
+#endif  // __CAMERA_H__
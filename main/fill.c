@@ -0,0 +1,88 @@
+#include "fill.h"
+
+#include <string.h>
+
+static const uint8_t bayer4[4][4] = {
+    {0, 8, 2, 10},
+    {12, 4, 14, 6},
+    {3, 11, 1, 9},
+    {15, 7, 13, 5},
+};
+
+void fill_clear_coverage(fill_target_t *t) {
+  memset(t->coverage, 0, t->width / 8 * t->height);
+}
+
+fill_pattern_t fill_pattern(int level) {
+  fill_pattern_t p;
+  for (int y = 0; y < 4; y++) {
+    uint8_t bits = 0;
+    for (int x = 0; x < 8; x++)
+      if (bayer4[y][x & 3] < level) bits |= 0x80 >> x;
+    p.rows[y] = bits;
+  }
+  return p;
+}
+
+// [x0, x1) 구간 중 아직 덮이지 않은 픽셀만 패턴으로 채움
+static void fill_span(fill_target_t *t, int y, int x0, int x1, uint8_t pat) {
+  if (x0 < 0) x0 = 0;
+  if (x1 > t->width) x1 = t->width;
+  if (x0 >= x1) return;
+
+  int stride = t->width / 8;
+  uint8_t *row = t->fb + y * stride;
+  uint8_t *cov = t->coverage + y * stride;
+  int b0 = x0 >> 3;
+  int b1 = (x1 - 1) >> 3;
+  uint8_t first = 0xff >> (x0 & 7);
+  uint8_t last = 0xff << (7 - ((x1 - 1) & 7));
+
+  for (int b = b0; b <= b1; b++) {
+    uint8_t mask = 0xff;
+    if (b == b0) mask &= first;
+    if (b == b1) mask &= last;
+    mask &= ~cov[b];
+    row[b] = (row[b] & ~mask) | (pat & mask);
+    cov[b] |= mask;
+  }
+}
+
+static inline int64_t edge_slope(const int16_t *p, const int16_t *q) {
+  return q[1] == p[1] ? 0 : (int64_t)(q[0] - p[0]) * 65536 / (q[1] - p[1]);
+}
+
+/*
+ * pixel centres on integer coordinates, top-left style rule: rows [top,
+ * bottom) and columns [ceil(left), ceil(right)), so faces sharing an edge
+ * neither overlap nor leave a gap. edges are stepped in 16.16 fixed point,
+ * 64 bit because clamped off screen vertices can be 2^14 pixels away.
+ */
+void fill_triangle(fill_target_t *t, const int16_t *a, const int16_t *b,
+                   const int16_t *c, const fill_pattern_t *pattern) {
+  const int16_t *tmp;
+  // y 기준 정렬: a가 위, c가 아래
+  if (a[1] > b[1]) tmp = a, a = b, b = tmp;
+  if (b[1] > c[1]) tmp = b, b = c, c = tmp;
+  if (a[1] > b[1]) tmp = a, a = b, b = tmp;
+  if (a[1] == c[1]) return;
+
+  int64_t long_dx = edge_slope(a, c);
+  int64_t top_dx = edge_slope(a, b);
+  int64_t bottom_dx = edge_slope(b, c);
+  int y0 = a[1] < 0 ? 0 : a[1];
+  int y1 = c[1] > t->height ? t->height : c[1];
+
+  for (int y = y0; y < y1; y++) {
+    int64_t x0 = (int64_t)a[0] * 65536 + long_dx * (y - a[1]);
+    int64_t x1 = y < b[1] ? (int64_t)a[0] * 65536 + top_dx * (y - a[1])
+                          : (int64_t)b[0] * 65536 + bottom_dx * (y - b[1]);
+    if (x0 > x1) {
+      int64_t x = x0;
+      x0 = x1;
+      x1 = x;
+    }
+    fill_span(t, y, (x0 + 0xffff) >> 16, (x1 + 0xffff) >> 16,
+              pattern->rows[y & 3]);
+  }
+}
@@ -0,0 +1,38 @@
+#ifndef __FILL_H__
+#define __FILL_H__
+
+#include <stdint.h>
+
+/*
+ * scanline polygon fill for 1bpp frames. there is no z-buffer: faces are
+ * drawn front to back and a 1bpp coverage bitmap (the span buffer) masks out
+ * pixels that were already written, a byte at a time. shading is a 4x4 bayer
+ * dither pattern, one byte per row since the pattern repeats every 4 pixels.
+ */
+
+#define FILL_LEVELS 16  // shade 0 (black) .. FILL_LEVELS (white)
+
+typedef struct {
+  uint8_t *fb;        // row major, MSB first
+  uint8_t *coverage;  // same layout, set where a face was already drawn
+  int width;          // multiple of 8
+  int height;
+} fill_target_t;
+
+typedef struct {
+  uint8_t rows[4];
+} fill_pattern_t;
+
+// twice the signed screen area, positive for faces towards the camera
+static inline int32_t fill_area2(const int16_t *a, const int16_t *b,
+                                 const int16_t *c) {
+  return (int32_t)(b[0] - a[0]) * (c[1] - a[1]) -
+         (int32_t)(b[1] - a[1]) * (c[0] - a[0]);
+}
+
+void fill_clear_coverage(fill_target_t *t);
+fill_pattern_t fill_pattern(int level);
+void fill_triangle(fill_target_t *t, const int16_t *a, const int16_t *b,
+                   const int16_t *c, const fill_pattern_t *pattern);
+
+#endif  // __FILL_H__
@@ -0,0 +1,169 @@
+#include "frame.h"
+
+#include <inttypes.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "heap_tag.h"
+#include "lcd.h"
+
+#define TAG "FRAME"
+#define CHECK_ALLOC(ptr)                                    \
+  do {                                                      \
+    if (ptr == NULL) {                                      \
+      ESP_LOGE(TAG, "Failed to allocate memory: %s", #ptr); \
+      abort();                                              \
+    }                                                       \
+  } while (0)
+
+frame_tribuf_t *frame_tribuf_create(uint8_t planes) {
+  frame_tribuf_t *tb = heap_tag_calloc(HEAP_TAG_RENDER, 1,
+                                       sizeof(frame_tribuf_t), MALLOC_CAP_8BIT);
+  CHECK_ALLOC(tb);
+  for (int i = 0; i < FRAME_BUF_COUNT; i++) {
+    tb->bufs[i] = heap_tag_calloc(HEAP_TAG_RENDER, LCD_BUF_SIZE * planes,
+                                  sizeof(uint8_t), MALLOC_CAP_8BIT);
+    CHECK_ALLOC(tb->bufs[i]);
+    tb->dirty[i] = (frame_rect_t){0, 0, LCD_WIDTH - 1, LCD_HEIGHT - 1};
+  }
+  tb->back = 0;
+  tb->front = 1;
+  atomic_init(&tb->ready, 2);
+  atomic_init(&tb->published, 0);
+  atomic_init(&tb->dropped, 0);
+  return tb;
+}
+
+uint8_t *frame_tribuf_back(frame_tribuf_t *tb) { return tb->bufs[tb->back]; }
+
+void frame_tribuf_publish(frame_tribuf_t *tb, const frame_rect_t *dirty) {
+  tb->dirty[tb->back] = *dirty;
+  uint8_t prev = atomic_load_explicit(&tb->ready, memory_order_acquire);
+  do {
+    // 소비되지 않은 프레임을 덮어쓰게 되면 그 변경 영역도 넘겨받음, 교환이
+    // 실패해 합친 영역이 남더라도 더 넓게 갱신할 뿐이라 안전함
+    if (prev & FRAME_READY_FRESH)
+      frame_rect_union(&tb->dirty[tb->back],
+                       &tb->dirty[prev & FRAME_READY_INDEX_MASK]);
+  } while (!atomic_compare_exchange_weak_explicit(
+      &tb->ready, &prev, tb->back | FRAME_READY_FRESH, memory_order_acq_rel,
+      memory_order_acquire));
+  if (prev & FRAME_READY_FRESH)
+    atomic_fetch_add_explicit(&tb->dropped, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&tb->published, 1, memory_order_relaxed);
+  tb->back = prev & FRAME_READY_INDEX_MASK;
+}
+
+const uint8_t *frame_tribuf_acquire(frame_tribuf_t *tb, bool *fresh,
+                                    frame_rect_t *dirty) {
+  *fresh = false;
+  *dirty = FRAME_RECT_EMPTY;
+  if (atomic_load_explicit(&tb->ready, memory_order_acquire) &
+      FRAME_READY_FRESH) {
+    uint8_t prev = atomic_exchange_explicit(&tb->ready, tb->front,
+                                            memory_order_acq_rel);
+    tb->front = prev & FRAME_READY_INDEX_MASK;
+    *fresh = true;
+    *dirty = tb->dirty[tb->front];
+  }
+  return tb->bufs[tb->front];
+}
+
+static bool IRAM_ATTR frame_timer_cb(gptimer_handle_t timer,
+                                     const gptimer_alarm_event_data_t *edata,
+                                     void *user_ctx) {
+  frame_sched_t *s = user_ctx;
+  BaseType_t woken = pdFALSE;
+
+  atomic_store_explicit(&s->tick_us, (uint32_t)esp_timer_get_time(),
+                        memory_order_relaxed);
+  vTaskNotifyGiveFromISR(s->render_task, &woken);
+  return woken == pdTRUE;
+}
+
+frame_sched_t *frame_sched_create(uint32_t fps) {
+  frame_sched_t *s = heap_tag_calloc(HEAP_TAG_RENDER, 1, sizeof(frame_sched_t),
+                                     MALLOC_CAP_8BIT);
+  CHECK_ALLOC(s);
+  atomic_init(&s->period_us, 1000000 / fps);
+
+  gptimer_config_t timer_config = {
+      .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+      .direction = GPTIMER_COUNT_UP,
+      .resolution_hz = 1 * 1000 * 1000,
+  };
+  ESP_ERROR_CHECK(gptimer_new_timer(&timer_config, &s->timer));
+  gptimer_event_callbacks_t timer_cbs = {
+      .on_alarm = frame_timer_cb,
+  };
+  ESP_ERROR_CHECK(gptimer_register_event_callbacks(s->timer, &timer_cbs, s));
+  ESP_ERROR_CHECK(gptimer_enable(s->timer));
+  return s;
+}
+
+// 0 fps나 1us보다 짧은 주기는 거부하고 이전 주기를 유지
+bool frame_sched_set_fps(frame_sched_t *s, uint32_t fps) {
+  if (fps == 0 || fps > 1000000) {
+    ESP_LOGW(TAG, "Invalid frame rate: %" PRIu32 " fps", fps);
+    return false;
+  }
+  uint32_t period_us = 1000000 / fps;
+  gptimer_alarm_config_t alarm_config = {
+      .reload_count = 0,                   // counter will reload with 0
+      .alarm_count = period_us,            // alarm period in us
+      .flags.auto_reload_on_alarm = true,  // enable auto-reload
+  };
+  atomic_store(&s->period_us, period_us);
+  ESP_ERROR_CHECK(gptimer_set_alarm_action(s->timer, &alarm_config));
+  ESP_LOGI(TAG, "Target frame rate: %" PRIu32 " fps", fps);
+  return true;
+}
+
+void frame_sched_start(frame_sched_t *s, TaskHandle_t render_task,
+                       TaskHandle_t present_task) {
+  s->render_task = render_task;
+  s->present_task = present_task;
+  frame_sched_set_fps(s, 1000000 / atomic_load(&s->period_us));
+  ESP_ERROR_CHECK(gptimer_start(s->timer));
+}
+
+// 프레임을 시작하는 순간의 알람으로 기한을 정함, 렌더 중에 다음 알람이
+// 와서 tick_us가 바뀌어도 이 프레임의 기한은 그대로
+void frame_sched_wait_render(frame_sched_t *s) {
+  ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  s->deadline_us = atomic_load(&s->tick_us) + atomic_load(&s->period_us);
+}
+
+// 늦은 프레임은 여기서만 셈, 밀린 알람은 다음 프레임이 바로 시작할 뿐
+void frame_sched_rendered(frame_sched_t *s) {
+  uint32_t now = (uint32_t)esp_timer_get_time();
+  if ((int32_t)(now - s->deadline_us) > 0) atomic_fetch_add(&s->late, 1);
+  atomic_fetch_add(&s->rendered, 1);
+  xTaskNotifyGive(s->present_task);
+}
+
+void frame_sched_wait_present(frame_sched_t *s) {
+  // 한 주기 반 동안 새 프레임이 없으면 이전 프레임을 다시 보여준다
+  uint32_t period_ms = atomic_load(&s->period_us) / 1000;
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(period_ms + period_ms / 2));
+}
+
+void frame_sched_presented(frame_sched_t *s, bool fresh) {
+  if (fresh)
+    atomic_fetch_add(&s->presented, 1);
+  else
+    atomic_fetch_add(&s->duplicated, 1);
+}
+
+void frame_sched_report(frame_sched_t *s, frame_tribuf_t *tb) {
+  uint32_t dropped = atomic_load(&tb->dropped);
+  ESP_LOGI(TAG,
+           "%" PRIu32 " fps target: %" PRIu32 " rendered, %" PRIu32
+           " presented, %" PRIu32 " dropped, %" PRIu32 " duplicated, %" PRIu32
+           " late",
+           1000000 / atomic_load(&s->period_us),
+           atomic_exchange(&s->rendered, 0), atomic_exchange(&s->presented, 0),
+           dropped - s->last_dropped,
+           atomic_exchange(&s->duplicated, 0), atomic_exchange(&s->late, 0));
+  s->last_dropped = dropped;
+}
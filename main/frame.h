@@ -0,0 +1,101 @@
+#ifndef __FRAME_H__
+#define __FRAME_H__
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "driver/gptimer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define FRAME_BUF_COUNT 3
+#define FRAME_READY_FRESH 0x80
+#define FRAME_READY_INDEX_MASK 0x03
+
+// a full SSD1306 flush takes ~23ms at 400kHz I2C, 60 fps is not reachable
+#define FRAME_TARGET_FPS 30
+
+// inclusive pixel bounds, empty when x2 < x1
+typedef struct {
+  int16_t x1, y1, x2, y2;
+} frame_rect_t;
+
+#define FRAME_RECT_EMPTY ((frame_rect_t){0, 0, -1, -1})
+
+static inline bool frame_rect_is_empty(const frame_rect_t *r) {
+  return r->x2 < r->x1;
+}
+
+static inline void frame_rect_union(frame_rect_t *a, const frame_rect_t *b) {
+  if (frame_rect_is_empty(b)) return;
+  if (frame_rect_is_empty(a)) {
+    *a = *b;
+    return;
+  }
+  if (b->x1 < a->x1) a->x1 = b->x1;
+  if (b->y1 < a->y1) a->y1 = b->y1;
+  if (b->x2 > a->x2) a->x2 = b->x2;
+  if (b->y2 > a->y2) a->y2 = b->y2;
+}
+
+/*
+ * lock-free triple buffer between the render task (producer) and the LVGL
+ * task (consumer). `back` is owned by the producer, `front` by the consumer
+ * and `ready` holds the latest completed frame. both sides only ever swap
+ * their own index with `ready`, so neither side waits on the other.
+ *
+ * each buffer carries the region that changed since the frame before it.
+ * when a frame is overwritten unseen its region is merged into the next
+ * one, so the consumer always gets the change since what it last showed.
+ * with more than one plane the planes of a buffer sit LCD_BUF_SIZE apart
+ * and are handed over together.
+ */
+typedef struct {
+  uint8_t *bufs[FRAME_BUF_COUNT];
+  frame_rect_t dirty[FRAME_BUF_COUNT];
+  uint8_t back;                // render task only
+  uint8_t front;               // LVGL task only
+  _Atomic uint8_t ready;       // buffer index | FRAME_READY_FRESH
+  _Atomic uint32_t published;  // frames handed over by the producer
+  _Atomic uint32_t dropped;    // frames overwritten before being picked up
+} frame_tribuf_t;
+
+frame_tribuf_t *frame_tribuf_create(uint8_t planes);
+uint8_t *frame_tribuf_back(frame_tribuf_t *tb);
+void frame_tribuf_publish(frame_tribuf_t *tb, const frame_rect_t *dirty);
+const uint8_t *frame_tribuf_acquire(frame_tribuf_t *tb, bool *fresh,
+                                    frame_rect_t *dirty);
+
+/*
+ * single frame clock for the whole pipeline. the gptimer alarm fires once per
+ * target period and wakes the render task; the render task wakes the LVGL
+ * task after publishing, which then does exactly one present, refresh and
+ * flush. LVGL's own display refresh timer is paused.
+ */
+typedef struct {
+  gptimer_handle_t timer;
+  TaskHandle_t render_task;
+  TaskHandle_t present_task;
+  _Atomic uint32_t period_us;
+  _Atomic uint32_t tick_us;  // low 32 bits of esp_timer at the last alarm
+  uint32_t deadline_us;      // render task only, latched when a frame starts
+  // counters since the last report
+  _Atomic uint32_t rendered;
+  _Atomic uint32_t presented;
+  _Atomic uint32_t duplicated;  // periods that re-showed the previous frame
+  _Atomic uint32_t late;        // frames finished after their deadline
+  uint32_t last_dropped;
+} frame_sched_t;
+
+frame_sched_t *frame_sched_create(uint32_t fps);
+void frame_sched_start(frame_sched_t *s, TaskHandle_t render_task,
+                       TaskHandle_t present_task);
+bool frame_sched_set_fps(frame_sched_t *s, uint32_t fps);
+void frame_sched_wait_render(frame_sched_t *s);
+void frame_sched_rendered(frame_sched_t *s);
+void frame_sched_wait_present(frame_sched_t *s);
+void frame_sched_presented(frame_sched_t *s, bool fresh);
+void frame_sched_report(frame_sched_t *s, frame_tribuf_t *tb);
+
+#endif  // __FRAME_H__
@@ -0,0 +1,200 @@
+#include "gray.h"
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "heap_tag.h"
+#include "raster.h"
+
+#define TAG "GRAY"
+
+// 가까울수록 밝게, GRAY_DEPTH_NEAR 앞은 3, GRAY_DEPTH_FAR 뒤는 1
+uint8_t gray_level(float depth) {
+  float t = (GRAY_DEPTH_FAR - depth) / (GRAY_DEPTH_FAR - GRAY_DEPTH_NEAR);
+  if (t <= 0) return 1;
+  if (t >= 1) return GRAY_LEVELS;
+  return 1 + (int)(t * (GRAY_LEVELS - 1) + 0.5f);
+}
+
+#if GRAY_ENABLED
+
+#define CHECK_ALLOC(ptr)                                    \
+  do {                                                      \
+    if (ptr == NULL) {                                      \
+      ESP_LOGE(TAG, "Failed to allocate memory: %s", #ptr); \
+      abort();                                              \
+    }                                                       \
+  } while (0)
+
+static void xor_pages(gray_sched_t *g, uint8_t *pages, uint8_t mask) {
+  for (int page = 0; page < LCD_HEIGHT / 8; page++) {
+    if (!(mask >> page & 1)) continue;
+    uint8_t *dst = pages + LCD_WIDTH * page;
+    const uint8_t *src = g->diff + LCD_WIDTH * page;
+    for (int x = 0; x < LCD_WIDTH; x++) dst[x] ^= src[x];
+  }
+}
+
+// 슬롯마다 보여야 할 plane과 패널 상태가 다른 page 행만 뒤집어 보냄
+static void flip(gray_sched_t *g, bool restore) {
+  uint8_t *pages = lcd_pages_lock(g->lcd);
+  if (!pages) return;
+  int64_t start = esp_timer_get_time();
+  bool plane1 = !restore && g->slot % GRAY_CYCLE == GRAY_CYCLE - 1;
+  uint8_t want = plane1 ? g->diff_pages : 0;
+  uint8_t changed = g->inverted ^ want;
+  xor_pages(g, pages, changed);
+  g->inverted = want;
+  lcd_pages_unlock(g->lcd, changed);
+  uint32_t us = esp_timer_get_time() - start;
+
+  g->slot++;
+  atomic_fetch_add(&g->flips, 1);
+  atomic_fetch_add(&g->pages_sent, __builtin_popcount(changed));
+  uint32_t max = atomic_load(&g->flip_us_max);
+  if (us > max) atomic_store(&g->flip_us_max, us);
+}
+
+static void gray_task(void *pvParameters) {
+  gray_sched_t *g = pvParameters;
+  TickType_t wake = xTaskGetTickCount();
+  int64_t window_start = esp_timer_get_time();
+  uint32_t window_flips = 0, slow_seconds = 0;
+
+  while (true) {
+    flip(g, false);
+    window_flips++;
+
+    // 다음 슬롯이 이미 지났으면 밀린 슬롯을 몰아 돌지 않고 지금부터 다시 셈.
+    // 그래도 한 tick은 쉬어야 lcd_buf_lock을 기다리는 낮은 우선순위의
+    // lvgl_flush_cb가 차례를 얻음
+    TickType_t now = xTaskGetTickCount();
+    if (now - wake >= pdMS_TO_TICKS(GRAY_FLIP_PERIOD_MS)) {
+      atomic_fetch_add(&g->missed, 1);
+      vTaskDelay(1);
+      wake = xTaskGetTickCount();
+    } else {
+      vTaskDelayUntil(&wake, pdMS_TO_TICKS(GRAY_FLIP_PERIOD_MS));
+    }
+
+    int64_t elapsed = esp_timer_get_time() - window_start;
+    if (elapsed < 1000000) continue;
+    uint32_t rate = window_flips * 1000000LL / elapsed;
+    slow_seconds = rate * 100 < GRAY_FLIP_HZ * GRAY_MIN_RATE_PCT
+                       ? slow_seconds + 1
+                       : 0;
+    if (slow_seconds >= GRAY_FALLBACK_SECONDS) break;
+    window_start += elapsed;
+    window_flips = 0;
+  }
+
+  ESP_LOGW(TAG, "Flip rate stayed under %d%% of %d Hz, falling back to 1bpp",
+           GRAY_MIN_RATE_PCT, GRAY_FLIP_HZ);
+  atomic_store(&g->fallback, true);
+  flip(g, true);
+  vTaskDelete(NULL);
+}
+
+gray_sched_t *gray_create(ssd1306_lcd_panel_t *lcd) {
+  gray_sched_t *g = heap_tag_calloc(HEAP_TAG_LCD, 1, sizeof(gray_sched_t),
+                                    MALLOC_CAP_8BIT);
+  CHECK_ALLOC(g);
+  g->lcd = lcd;
+  return g;
+}
+
+// lcd_buf_lock, 패널, LVGL이 모두 준비된 뒤 app_main에서 부름
+void gray_start(gray_sched_t *g) {
+  if (!g) return;
+  g->reported_us = esp_timer_get_time();
+  xTaskCreate(gray_task, "gray_task", GRAY_TASK_STACK_SIZE, g,
+              GRAY_TASK_PRIORITY, &g->task);
+  trace_register_task(g->task);
+}
+
+bool gray_active(const gray_sched_t *g) {
+  return g && !atomic_load_explicit(&g->fallback, memory_order_acquire);
+}
+
+// render_present에서 불림, 바뀐 행의 두 plane 차이를 page 형식으로 보관
+void gray_submit(gray_sched_t *g, const uint8_t *plane0,
+                 const uint8_t *plane1, int y1, int y2) {
+  y1 &= ~7;
+  y2 |= 7;
+  for (int i = y1 * RASTER_STRIDE; i < (y2 + 1) * RASTER_STRIDE; i++)
+    g->xor_rows[i] = plane0[i] ^ plane1[i];
+  raster_to_pages(g->xor_rows, g->pending, 0, y1, LCD_WIDTH - 1, y2);
+}
+
+// 캔버스 위에 그려진 영역과 겹치는 diff 비트를 지움
+static void mask_overlay(uint8_t *diff, int page, const frame_rect_t *r) {
+  int y1 = r->y1 > page * 8 ? r->y1 - page * 8 : 0;
+  int y2 = r->y2 < page * 8 + 7 ? r->y2 - page * 8 : 7;
+  if (frame_rect_is_empty(r) || y1 > y2) return;
+  int x1 = r->x1 > 0 ? r->x1 : 0;
+  int x2 = r->x2 < LCD_WIDTH - 1 ? r->x2 : LCD_WIDTH - 1;
+  uint8_t keep = ~(0xff << y1 & 0xff >> (7 - y2));
+  for (int x = x1; x <= x2; x++) diff[x] &= keep;
+}
+
+// lvgl_flush_cb가 lcd_buf_lock을 쥔 채 부름, 이 page들은 이제 plane 0
+void gray_flushed(gray_sched_t *g, int page1, int page2,
+                  const frame_rect_t *overlay, int overlay_count) {
+  for (int page = page1; page <= page2; page++) {
+    uint8_t *dst = g->diff + LCD_WIDTH * page;
+    memcpy(dst, g->pending + LCD_WIDTH * page, LCD_WIDTH);
+    for (int i = 0; i < overlay_count; i++)
+      mask_overlay(dst, page, &overlay[i]);
+    uint16_t pixels = 0;
+    for (int x = 0; x < LCD_WIDTH; x++) pixels += __builtin_popcount(dst[x]);
+    g->page_pixels[page] = pixels;
+    if (pixels)
+      g->diff_pages |= 1 << page;
+    else
+      g->diff_pages &= ~(1 << page);
+    g->inverted &= ~(1 << page);
+  }
+}
+
+// 보고 주기가 정확히 맞지 않아 실제 경과 시간으로 나눔
+void gray_report(gray_sched_t *g) {
+  int64_t now = esp_timer_get_time();
+  int64_t elapsed_us = now - g->reported_us;
+  g->reported_us = now;
+  uint32_t flips = atomic_exchange(&g->flips, 0);
+  uint32_t missed = atomic_exchange(&g->missed, 0);
+  uint32_t pages = atomic_exchange(&g->pages_sent, 0);
+  uint32_t flip_us_max = atomic_exchange(&g->flip_us_max, 0);
+  if (atomic_load(&g->fallback)) return;
+
+  // 어두운 픽셀은 사이클마다 한 번 깜빡이므로 사이클 주파수가 곧 깜빡임 주파수
+  uint32_t rate = flips * 1000000LL / elapsed_us;
+  uint32_t cycle_hz = rate / GRAY_CYCLE;
+  uint32_t flicker_px = 0;
+  for (int page = 0; page < LCD_HEIGHT / 8; page++)
+    flicker_px += g->page_pixels[page];
+  ESP_LOGI(TAG,
+           "%" PRIu32 "/%d flips/s, %" PRIu32 " Hz cycle%s, %" PRIu32
+           " missed, %" PRIu32 ".%" PRIu32 " pages/flip, max %" PRIu32
+           " us, %" PRIu32 " px flickering",
+           rate, GRAY_FLIP_HZ, cycle_hz,
+           cycle_hz < GRAY_FUSION_HZ ? " (visible)" : "", missed,
+           flips ? pages / flips : 0, flips ? pages * 10 / flips % 10 : 0,
+           flip_us_max, flicker_px);
+}
+
+#else
+
+gray_sched_t *gray_create(ssd1306_lcd_panel_t *lcd) { return NULL; }
+void gray_start(gray_sched_t *g) {}
+bool gray_active(const gray_sched_t *g) { return false; }
+void gray_submit(gray_sched_t *g, const uint8_t *plane0,
+                 const uint8_t *plane1, int y1, int y2) {}
+void gray_flushed(gray_sched_t *g, int page1, int page2,
+                  const frame_rect_t *overlay, int overlay_count) {}
+void gray_report(gray_sched_t *g) {}
+
+#endif  // GRAY_ENABLED
@@ -0,0 +1,81 @@
+#ifndef __GRAY_H__
+#define __GRAY_H__
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "frame.h"
+#include "freertos/task.h"
+#include "lcd.h"
+
+/*
+ * temporal dither for the 1bpp panel. the render task draws every edge at
+ * one of three depth levels into two planes of the frame: plane 0 (levels
+ * 2 and 3) and plane 1 (levels 1 and 3). lvgl_flush_cb puts plane 0 on the
+ * panel as usual; a flip task then shows plane 1 for one slot in every
+ * GRAY_CYCLE by XORing plane 0 ^ plane 1 into lcd_buf, and XORs it back on
+ * the next slot. only page rows where the planes differ are sent, so a
+ * level 3 edge stays lit, level 2 is lit 2/3 of the time and level 1 1/3.
+ * lvgl_flush_cb passes the areas drawn over the canvas (the labels, or the
+ * whole panel while the monitor screen is shown) and the diff is cleared
+ * there, so flips never touch those pixels.
+ * gray_create only allocates; app_main starts the flip task with gray_start
+ * once lcd_buf_lock, the panel and LVGL are up.
+ *
+ * a full flush costs ~23ms at 400kHz I2C, so the flip rate depends on how
+ * few page rows carry dim edges. when the achieved rate stays under
+ * GRAY_MIN_RATE_PCT of GRAY_FLIP_HZ the scheduler restores plane 0 and the
+ * renderer goes back to plain 1bpp for good.
+ */
+
+#ifndef GRAY_ENABLED
+#define GRAY_ENABLED 0
+#endif
+#define GRAY_FLIP_PERIOD_MS 5  // whole ticks, 200 slots/s
+#define GRAY_FLIP_HZ (1000 / GRAY_FLIP_PERIOD_MS)
+#define GRAY_CYCLE 3  // slots per cycle, the last one shows plane 1
+#define GRAY_FUSION_HZ 50  // cycles below this are seen as flicker
+#define GRAY_MIN_RATE_PCT 90
+#define GRAY_FALLBACK_SECONDS 3  // consecutive slow seconds before 1bpp
+// view space depth of the brightest and dimmest level, the camera is 8
+// units from the objects which reach about 1 unit towards and away from it
+#define GRAY_DEPTH_NEAR 7.4f
+#define GRAY_DEPTH_FAR 8.6f
+#define GRAY_LEVELS 3
+
+#define GRAY_TASK_STACK_SIZE 2560
+#define GRAY_TASK_PRIORITY 6  // above LVGL so slots keep their timing
+
+struct gray_sched_s {
+  ssd1306_lcd_panel_t *lcd;
+  uint8_t pending[LCD_BUF_SIZE];  // plane 0 ^ plane 1, LVGL task only
+  uint8_t xor_rows[LCD_BUF_SIZE];  // row major scratch for pending
+  // under lcd_buf_lock
+  uint8_t diff[LCD_BUF_SIZE];  // pending for the page rows on the panel
+  uint16_t page_pixels[LCD_HEIGHT / 8];  // set bits of diff per page row
+  uint8_t diff_pages;  // page rows with a nonzero diff
+  uint8_t inverted;    // page rows currently showing plane 1
+  TaskHandle_t task;
+  uint32_t slot;
+  _Atomic bool fallback;  // set once by the flip task, never cleared
+  // since the last report
+  _Atomic uint32_t flips;
+  _Atomic uint32_t missed;  // slots that started after the next was due
+  _Atomic uint32_t pages_sent;
+  _Atomic uint32_t flip_us_max;
+  int64_t reported_us;  // stats task only, from gray_start
+};
+
+gray_sched_t *gray_create(ssd1306_lcd_panel_t *lcd);
+void gray_start(gray_sched_t *g);
+bool gray_active(const gray_sched_t *g);
+uint8_t gray_level(float depth);
+void gray_submit(gray_sched_t *g, const uint8_t *plane0,
+                 const uint8_t *plane1, int y1, int y2);
+void gray_flushed(gray_sched_t *g, int page1, int page2,
+                  const frame_rect_t *overlay, int overlay_count);
+void gray_report(gray_sched_t *g);
+
+#endif  // __GRAY_H__
@@ -0,0 +1,136 @@
+#include "heap_tag.h"
+
+#include <inttypes.h>
+
+#include "esp_log.h"
+#include "lvgl.h"
+#include "sdkconfig.h"
+
+#define TAG "HEAP"
+
+static heap_tag_stats_t tags[HEAP_TAG_COUNT];
+static const char *const tag_names[HEAP_TAG_COUNT] = {
+    [HEAP_TAG_LCD] = "lcd",
+    [HEAP_TAG_RENDER] = "render",
+    [HEAP_TAG_LVGL] = "lvgl",
+};
+
+static void book_alloc(heap_tag_t tag, void *ptr) {
+  if (!ptr) return;
+  heap_tag_stats_t *s = &tags[tag];
+  uint32_t size = heap_caps_get_allocated_size(ptr);
+  uint32_t live = atomic_fetch_add(&s->live_bytes, size) + size;
+  // 태그마다 쓰는 태스크가 사실상 하나라 peak 갱신 경쟁은 무시
+  if (live > atomic_load(&s->peak_bytes)) atomic_store(&s->peak_bytes, live);
+  atomic_fetch_add(&s->allocs, 1);
+}
+
+static void book_free(heap_tag_t tag, void *ptr) {
+  if (!ptr) return;
+  heap_tag_stats_t *s = &tags[tag];
+  atomic_fetch_sub(&s->live_bytes, heap_caps_get_allocated_size(ptr));
+  atomic_fetch_add(&s->frees, 1);
+}
+
+void *heap_tag_malloc(heap_tag_t tag, size_t size, uint32_t caps) {
+  void *ptr = heap_caps_malloc(size, caps);
+  book_alloc(tag, ptr);
+  return ptr;
+}
+
+void *heap_tag_calloc(heap_tag_t tag, size_t n, size_t size, uint32_t caps) {
+  void *ptr = heap_caps_calloc(n, size, caps);
+  book_alloc(tag, ptr);
+  return ptr;
+}
+
+void *heap_tag_realloc(heap_tag_t tag, void *ptr, size_t size, uint32_t caps) {
+  size_t old = ptr ? heap_caps_get_allocated_size(ptr) : 0;
+  void *p = heap_caps_realloc(ptr, size, caps);
+  // 실패하면 원래 블록이 그대로 남으므로 장부도 그대로 둠
+  if (!p && size) return NULL;
+  heap_tag_stats_t *s = &tags[tag];
+  if (ptr) {
+    atomic_fetch_sub(&s->live_bytes, old);
+    atomic_fetch_add(&s->frees, 1);
+  }
+  book_alloc(tag, p);
+  return p;
+}
+
+void heap_tag_free(heap_tag_t tag, void *ptr) {
+  book_free(tag, ptr);
+  heap_caps_free(ptr);
+}
+
+void heap_sample(heap_sample_t *out) {
+  out->total = heap_caps_get_total_size(MALLOC_CAP_8BIT);
+  out->free = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  out->largest_free = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  out->min_free = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+  out->used_pct = (uint64_t)(out->total - out->free) * 100 / out->total;
+  out->frag_pct =
+      out->free ? 100 - (uint64_t)out->largest_free * 100 / out->free : 0;
+}
+
+void heap_tag_report(uint32_t period_ms) {
+  heap_sample_t h;
+  heap_sample(&h);
+  ESP_LOGI(TAG,
+           "heap: %" PRIu32 "/%" PRIu32 " free, largest %" PRIu32
+           ", min ever %" PRIu32 ", frag %u%%",
+           h.free, h.total, h.largest_free, h.min_free, h.frag_pct);
+  for (int i = 0; i < HEAP_TAG_COUNT; i++) {
+    heap_tag_stats_t *s = &tags[i];
+    uint32_t allocs = atomic_exchange(&s->allocs, 0);
+    uint32_t frees = atomic_exchange(&s->frees, 0);
+    ESP_LOGI(TAG,
+             "  %-6s live %" PRIu32 " peak %" PRIu32 ", %" PRIu32
+             " allocs/s %" PRIu32 " frees/s",
+             tag_names[i], atomic_load(&s->live_bytes),
+             atomic_load(&s->peak_bytes), allocs * 1000 / period_ms,
+             frees * 1000 / period_ms);
+  }
+}
+
+#if CONFIG_LV_USE_CUSTOM_MALLOC
+/*
+ * LV_STDLIB_CUSTOM backend: LVGL allocates from the system heap under
+ * HEAP_TAG_LVGL instead of a fixed pool, so its usage shows up next to
+ * everything else and the pool no longer reserves RAM it may not need.
+ */
+void lv_mem_init(void) {}
+
+void lv_mem_deinit(void) {}
+
+lv_mem_pool_t lv_mem_add_pool(void *mem, size_t bytes) { return NULL; }
+
+void lv_mem_remove_pool(lv_mem_pool_t pool) {}
+
+void *lv_malloc_core(size_t size) {
+  return heap_tag_malloc(HEAP_TAG_LVGL, size, MALLOC_CAP_8BIT);
+}
+
+void *lv_realloc_core(void *p, size_t new_size) {
+  return heap_tag_realloc(HEAP_TAG_LVGL, p, new_size, MALLOC_CAP_8BIT);
+}
+
+void lv_free_core(void *p) { heap_tag_free(HEAP_TAG_LVGL, p); }
+
+void lv_mem_monitor_core(lv_mem_monitor_t *mon_p) {
+  heap_sample_t h;
+  heap_sample(&h);
+  lv_memzero(mon_p, sizeof(*mon_p));
+  mon_p->total_size = h.total;
+  mon_p->free_size = h.free;
+  mon_p->free_biggest_size = h.largest_free;
+  mon_p->max_used = atomic_load(&tags[HEAP_TAG_LVGL].peak_bytes);
+  mon_p->used_pct = h.used_pct;
+  mon_p->frag_pct = h.frag_pct;
+}
+
+lv_result_t lv_mem_test_core(void) {
+  return heap_caps_check_integrity(MALLOC_CAP_8BIT, true) ? LV_RESULT_OK
+                                                          : LV_RESULT_INVALID;
+}
+#endif  // CONFIG_LV_USE_CUSTOM_MALLOC
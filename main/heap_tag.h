@@ -0,0 +1,50 @@
+#ifndef __HEAP_TAG_H__
+#define __HEAP_TAG_H__
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_heap_caps.h"
+
+/*
+ * allocation accounting per subsystem. the wrappers forward to heap_caps_*
+ * and book the real block size (heap_caps_get_allocated_size) against the
+ * tag, so there is no per-block header. LVGL allocates through the same
+ * wrappers (LV_STDLIB_CUSTOM, see heap_tag.c) instead of its builtin pool.
+ */
+
+#define HEAP_REPORT_PERIOD_MS 10000
+
+typedef enum {
+  HEAP_TAG_LCD,  // panel, LVGL draw buffers, UI queue
+  HEAP_TAG_RENDER,
+  HEAP_TAG_LVGL,
+  HEAP_TAG_COUNT,
+} heap_tag_t;
+
+typedef struct {
+  _Atomic uint32_t live_bytes;
+  _Atomic uint32_t peak_bytes;
+  _Atomic uint32_t allocs;  // since the last report
+  _Atomic uint32_t frees;
+} heap_tag_stats_t;
+
+// whole MALLOC_CAP_8BIT heap, all cheap to read (no block walk)
+typedef struct {
+  uint32_t total;
+  uint32_t free;
+  uint32_t largest_free;
+  uint32_t min_free;  // lowest free size since boot
+  uint8_t used_pct;
+  uint8_t frag_pct;  // 100 - largest_free * 100 / free
+} heap_sample_t;
+
+void *heap_tag_malloc(heap_tag_t tag, size_t size, uint32_t caps);
+void *heap_tag_calloc(heap_tag_t tag, size_t n, size_t size, uint32_t caps);
+void *heap_tag_realloc(heap_tag_t tag, void *ptr, size_t size, uint32_t caps);
+void heap_tag_free(heap_tag_t tag, void *ptr);
+void heap_sample(heap_sample_t *out);
+void heap_tag_report(uint32_t period_ms);
+
+#endif  // __HEAP_TAG_H__
@@ -0,0 +1,119 @@
+#include "impostor.h"
+
+#include <stdlib.h>
+
+#include "esp_log.h"
+#include "heap_tag.h"
+#include "lcd.h"
+#include "raster.h"
+
+#define TAG "IMPOSTOR"
+#define CHECK_ALLOC(ptr)                                    \
+  do {                                                      \
+    if (ptr == NULL) {                                      \
+      ESP_LOGE(TAG, "Failed to allocate memory: %s", #ptr); \
+      abort();                                              \
+    }                                                       \
+  } while (0)
+
+void impostor_cache_init(impostor_cache_t *cache, uint32_t budget) {
+  for (int i = 0; i < IMPOSTOR_CACHE_ENTRIES; i++)
+    cache->entries[i] = (impostor_t){0};
+  cache->budget = budget;
+  cache->bytes = 0;
+  cache->clock = 0;
+  cache->camera_version = 0;
+  cache->hits = cache->misses = cache->evictions = 0;
+  cache->scratch = heap_tag_calloc(HEAP_TAG_RENDER, LCD_BUF_SIZE,
+                                   sizeof(uint8_t), MALLOC_CAP_8BIT);
+  CHECK_ALLOC(cache->scratch);
+}
+
+static void impostor_free(impostor_cache_t *cache, impostor_t *e) {
+  cache->bytes -= e->stride * e->height;
+  heap_tag_free(HEAP_TAG_RENDER, e->bits);
+  e->bits = NULL;
+  e->used = false;
+}
+
+void impostor_cache_flush(impostor_cache_t *cache) {
+  for (int i = 0; i < IMPOSTOR_CACHE_ENTRIES; i++)
+    if (cache->entries[i].used) impostor_free(cache, &cache->entries[i]);
+}
+
+void impostor_quantize(const bam_t angle[3], bam_t out[3]) {
+  // 구간의 가운데 각도로 맞춰서 양쪽 오차를 반 칸 이내로 둠
+  const bam_t step = 1u << (32 - IMPOSTOR_ANGLE_BITS);
+  for (int i = 0; i < 3; i++) out[i] = (angle[i] & ~(step - 1)) + step / 2;
+}
+
+uint32_t impostor_key(uint8_t object, const bam_t angle[3]) {
+  uint32_t key = object;
+  for (int i = 0; i < 3; i++)
+    key = key << IMPOSTOR_ANGLE_BITS | angle[i] >> (32 - IMPOSTOR_ANGLE_BITS);
+  return key;
+}
+
+const impostor_t *impostor_lookup(impostor_cache_t *cache, uint32_t key) {
+  cache->clock++;
+  for (int i = 0; i < IMPOSTOR_CACHE_ENTRIES; i++) {
+    impostor_t *e = &cache->entries[i];
+    if (e->used && e->key == key) {
+      e->last_used = cache->clock;
+      cache->hits++;
+      return e;
+    }
+  }
+  cache->misses++;
+  return NULL;
+}
+
+static impostor_t *impostor_evict(impostor_cache_t *cache) {
+  impostor_t *victim = NULL;
+  for (int i = 0; i < IMPOSTOR_CACHE_ENTRIES; i++) {
+    impostor_t *e = &cache->entries[i];
+    if (e->used && (!victim || e->last_used < victim->last_used)) victim = e;
+  }
+  if (victim) {
+    impostor_free(cache, victim);
+    cache->evictions++;
+  }
+  return victim;
+}
+
+// scratch 프레임의 (x, y, width, height) 영역을 스프라이트로 저장
+const impostor_t *impostor_insert(impostor_cache_t *cache, uint32_t key,
+                                  int x, int y, int width, int height,
+                                  int origin_x, int origin_y) {
+  uint32_t stride = (width + 7) / 8;
+  uint32_t size = stride * height;
+  if (width > IMPOSTOR_MAX_SIZE || height > IMPOSTOR_MAX_SIZE ||
+      size > cache->budget)
+    return NULL;
+
+  impostor_t *slot = NULL;
+  for (int i = 0; i < IMPOSTOR_CACHE_ENTRIES && !slot; i++)
+    if (!cache->entries[i].used) slot = &cache->entries[i];
+  if (!slot) slot = impostor_evict(cache);
+  while (cache->bytes + size > cache->budget) impostor_evict(cache);
+
+  slot->bits = heap_tag_malloc(HEAP_TAG_RENDER, size, MALLOC_CAP_8BIT);
+  CHECK_ALLOC(slot->bits);
+  raster_copy_rect(cache->scratch, x, y, width, height, slot->bits, stride);
+  slot->key = key;
+  slot->last_used = cache->clock;
+  slot->width = width;
+  slot->height = height;
+  slot->stride = stride;
+  slot->origin_x = origin_x;
+  slot->origin_y = origin_y;
+  slot->used = true;
+  cache->bytes += size;
+  return slot;
+}
+
+void impostor_blit(uint8_t *fb, const impostor_t *sprite, int origin_x,
+                   int origin_y) {
+  raster_blit(fb, sprite->bits, sprite->stride, sprite->height,
+              origin_x + sprite->origin_x, origin_y + sprite->origin_y);
+}
@@ -0,0 +1,56 @@
+#ifndef __IMPOSTOR_H__
+#define __IMPOSTOR_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "anim.h"
+
+/*
+ * impostor (sprite) cache. objects spin at constant rates, so their
+ * silhouettes repeat: a wireframe rasterized once for a quantized pose is
+ * kept as a small 1bpp sprite and blitted on later frames. sprites are
+ * evicted least recently used first to stay under a byte budget.
+ */
+
+#define IMPOSTOR_ANGLE_BITS 5  // 32 steps per turn on each axis
+#define IMPOSTOR_CACHE_ENTRIES 64
+#define IMPOSTOR_CACHE_BUDGET 8192  // sprite bytes
+#define IMPOSTOR_MAX_SIZE 64        // larger silhouettes are drawn live
+
+typedef struct {
+  uint32_t key;
+  uint32_t last_used;
+  uint8_t *bits;  // 1bpp, row major, MSB first
+  uint8_t width;
+  uint8_t height;
+  uint8_t stride;
+  int16_t origin_x;  // top left corner relative to the projected origin
+  int16_t origin_y;
+  bool used;
+} impostor_t;
+
+typedef struct {
+  impostor_t entries[IMPOSTOR_CACHE_ENTRIES];
+  uint32_t budget;
+  uint32_t bytes;
+  uint32_t clock;
+  uint32_t camera_version;
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t evictions;
+  uint8_t *scratch;  // full frame to rasterize misses into
+} impostor_cache_t;
+
+void impostor_cache_init(impostor_cache_t *cache, uint32_t budget);
+void impostor_cache_flush(impostor_cache_t *cache);
+uint32_t impostor_key(uint8_t object, const bam_t angle[3]);
+void impostor_quantize(const bam_t angle[3], bam_t out[3]);
+const impostor_t *impostor_lookup(impostor_cache_t *cache, uint32_t key);
+const impostor_t *impostor_insert(impostor_cache_t *cache, uint32_t key,
+                                  int x, int y, int width, int height,
+                                  int origin_x, int origin_y);
+void impostor_blit(uint8_t *fb, const impostor_t *sprite, int origin_x,
+                   int origin_y);
+
+#endif  // __IMPOSTOR_H__
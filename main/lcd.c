@@ -1,11 +1,18 @@
 #include "lcd.h"
 
+#include <inttypes.h>
+
 #include "driver/i2c_master.h"
 #include "esp_lcd_panel_dev.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_panel_ops.h"
 #include "esp_lcd_panel_ssd1306.h"
+#include "esp_timer.h"
+#include "gray.h"
+#include "heap_tag.h"
+#include "prof.h"
 #include "render.h"
+#include "stream.h"
 
 #define TAG "LCD"
 #define CHECK_ALLOC(ptr)                                    \
@@ -16,37 +23,62 @@
     }                                                       \
   } while (0)
 
-static bool lv_tick_timer_cb(gptimer_handle_t timer,
-                             const gptimer_alarm_event_data_t *edata,
-                             void *user_ctx);
+static uint32_t lv_tick_cb(void);
+// 캔버스를 가리는 영역, gray flip이 건드리면 안 됨. 모니터 화면이면 전체
+static int canvas_overlay(ssd1306_lcd_panel_t *lcd, frame_rect_t *out) {
+  if (lv_display_get_screen_active(lcd->lv_disp) != lcd->main_screen) {
+    out[0] = (frame_rect_t){0, 0, LCD_WIDTH - 1, LCD_HEIGHT - 1};
+    return 1;
+  }
+  lv_obj_t *labels[] = {lcd->stat_label, lcd->prof_label};
+  int count = 0;
+  for (int i = 0; i < 2; i++) {
+    if (!labels[i]) continue;
+    lv_area_t a;
+    lv_obj_get_coords(labels[i], &a);
+    out[count++] = (frame_rect_t){a.x1, a.y1, a.x2, a.y2};
+  }
+  return count;
+}
+
 static void lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area,
                           uint8_t *px_map);
+static void lvgl_rounder_cb(lv_event_t *e);
 
 ssd1306_lcd_panel_t *lcd_setup(void) {
-  ssd1306_lcd_panel_t *lcd =
-      heap_caps_calloc(1, sizeof(ssd1306_lcd_panel_t), MALLOC_CAP_8BIT);
+  ssd1306_lcd_panel_t *lcd = heap_tag_calloc(HEAP_TAG_LCD, 1,
+                                             sizeof(ssd1306_lcd_panel_t),
+                                             MALLOC_CAP_8BIT);
   CHECK_ALLOC(lcd);
-  lcd->lcd_buf = heap_caps_calloc(LCD_BUF_SIZE, sizeof(uint8_t),
-                                  MALLOC_CAP_8BIT | MALLOC_CAP_DMA);
+  lcd->lcd_buf = heap_tag_calloc(HEAP_TAG_LCD, LCD_BUF_SIZE, sizeof(uint8_t),
+                                 MALLOC_CAP_8BIT | MALLOC_CAP_DMA);
   CHECK_ALLOC(lcd->lcd_buf);
-  lcd->draw_buf0 =
-      heap_caps_calloc(LVGL_DRAW_BUF_SIZE, sizeof(uint8_t), MALLOC_CAP_8BIT);
+  lcd->draw_buf0 = heap_tag_calloc(HEAP_TAG_LCD, LVGL_DRAW_BUF_SIZE,
+                                   sizeof(uint8_t), MALLOC_CAP_8BIT);
   CHECK_ALLOC(lcd->draw_buf0);
-  lcd->draw_buf1 =
-      heap_caps_calloc(LVGL_DRAW_BUF_SIZE, sizeof(uint8_t), MALLOC_CAP_8BIT);
+  lcd->draw_buf1 = heap_tag_calloc(HEAP_TAG_LCD, LVGL_DRAW_BUF_SIZE,
+                                   sizeof(uint8_t), MALLOC_CAP_8BIT);
   CHECK_ALLOC(lcd->draw_buf1);
-  lcd->canvas_buf =
-      heap_caps_calloc(lv_color_format_get_size(LV_COLOR_FORMAT_ARGB8888) *
-                           LCD_WIDTH / sizeof(uint8_t) * LCD_HEIGHT,
-                       sizeof(uint8_t), MALLOC_CAP_8BIT);
+  lcd->canvas_buf = heap_tag_calloc(HEAP_TAG_LCD, LVGL_DRAW_BUF_SIZE,
+                                    sizeof(uint8_t), MALLOC_CAP_8BIT);
   CHECK_ALLOC(lcd->canvas_buf);
+  lcd->mon_canvas_buf = heap_tag_calloc(HEAP_TAG_LCD, LVGL_DRAW_BUF_SIZE,
+                                        sizeof(uint8_t), MALLOC_CAP_8BIT);
+  CHECK_ALLOC(lcd->mon_canvas_buf);
+  lcd->sysmon = heap_tag_calloc(HEAP_TAG_LCD, 1, sizeof(sysmon_t),
+                                MALLOC_CAP_8BIT);
+  CHECK_ALLOC(lcd->sysmon);
+  sysmon_init(lcd->sysmon);
   ESP_LOGD(TAG, "LCD struct allocated");
 
-  lcd->lcd_buf_mutex = xSemaphoreCreateMutex();
-  CHECK_ALLOC(lcd->lcd_buf_mutex);
-  lcd->lvgl_mutex = xSemaphoreCreateMutex();
-  CHECK_ALLOC(lcd->lvgl_mutex);
+  // lcd_buf를 건드리는 것은 모두 이 락을 잡으므로 가장 먼저 만듦
+  traced_mutex_init(&lcd->lcd_buf_lock, "lcd_buf");
   ESP_LOGD(TAG, "LCD mutex created");
+  lcd->stream = stream_create();
+  // flip 태스크는 gray_start에서 시작, 여기서는 버퍼만 잡음
+  lcd->gray = gray_create(lcd);
+
+  lcd->ui_queue = ui_msg_queue_create();
 
   temperature_sensor_config_t temp_sensor_conf = {
       .range_min = 20,
@@ -103,113 +135,295 @@ ssd1306_lcd_panel_t *lcd_setup(void) {
   lcd->lv_disp = lv_display_create(LCD_WIDTH, LCD_HEIGHT);
   lv_display_set_user_data(lcd->lv_disp, lcd);
   lv_display_set_color_format(lcd->lv_disp, LV_COLOR_FORMAT_I1);
+  // DIRECT: 바뀐 영역만 다시 그리고 flush도 그 영역만 받음
   lv_display_set_buffers(lcd->lv_disp, lcd->draw_buf0, lcd->draw_buf1,
-                         LVGL_DRAW_BUF_SIZE, LV_DISPLAY_RENDER_MODE_FULL);
+                         LVGL_DRAW_BUF_SIZE, LV_DISPLAY_RENDER_MODE_DIRECT);
   lv_display_set_flush_cb(lcd->lv_disp, lvgl_flush_cb);
+  lv_display_add_event_cb(lcd->lv_disp, lvgl_rounder_cb,
+                          LV_EVENT_INVALIDATE_AREA, NULL);
+  // 화면 갱신은 frame_sched가 프레임마다 lv_refr_now로 직접 구동
+  lv_timer_pause(lv_display_get_refr_timer(lcd->lv_disp));
   ESP_LOGD(TAG, "LVGL display created");
 
   return lcd;
 }
 
-void setup_lv_timer(ssd1306_lcd_panel_t *lcd) {
-  gptimer_config_t timer_config = {
-      .clk_src = GPTIMER_CLK_SRC_DEFAULT,
-      .direction = GPTIMER_COUNT_UP,
-      .resolution_hz = 1 * 1000 * 1000,
-  };
-  ESP_ERROR_CHECK(gptimer_new_timer(&timer_config, &lcd->lv_tick_timer));
-  gptimer_alarm_config_t alarm_config = {
-      .reload_count = 0,  // counter will reload with 0 on alarm event
-      .alarm_count = LV_TICK_PERIOD_MS * 1000,  // alarm period in us
-      .flags.auto_reload_on_alarm = true,       // enable auto-reload
-  };
-  ESP_ERROR_CHECK(gptimer_set_alarm_action(lcd->lv_tick_timer, &alarm_config));
-  gptimer_event_callbacks_t timer_cbs = {
-      .on_alarm = lv_tick_timer_cb,
-  };
-  ESP_ERROR_CHECK(
-      gptimer_register_event_callbacks(lcd->lv_tick_timer, &timer_cbs, lcd));
-  ESP_ERROR_CHECK(gptimer_enable(lcd->lv_tick_timer));
-  ESP_ERROR_CHECK(gptimer_start(lcd->lv_tick_timer));
+void setup_lv_timer(ssd1306_lcd_panel_t *lcd) { lv_tick_set_cb(lv_tick_cb); }
+
+// LVGL을 거치지 않는 출력(video_play)이 lcd_buf에 page 형식으로 직접 씀
+uint8_t *lcd_pages_lock(ssd1306_lcd_panel_t *lcd) {
+  if (!traced_mutex_take(&lcd->lcd_buf_lock,
+                         pdMS_TO_TICKS(LCD_BUF_LOCK_TIMEOUT_MS))) {
+    ESP_LOGW(TAG, "Failed to take lcd_buf lock");
+    return NULL;
+  }
+  return lcd->lcd_buf;
 }
 
-static void update_label_cb(lv_timer_t *timer);
+// 연속된 dirty page 행마다 한 번씩 전송
+void lcd_pages_unlock(ssd1306_lcd_panel_t *lcd, uint8_t page_mask) {
+  for (int page = 0; page < LCD_HEIGHT / 8;) {
+    if (!(page_mask >> page & 1)) {
+      page++;
+      continue;
+    }
+    int first = page;
+    while (page < LCD_HEIGHT / 8 && page_mask >> page & 1) page++;
+    ESP_ERROR_CHECK(esp_lcd_panel_draw_bitmap(
+        lcd->panel_handle, 0, first * 8, LCD_WIDTH, page * 8,
+        lcd->lcd_buf + LCD_WIDTH * first));
+  }
+  if (lcd->stream && page_mask) stream_submit(lcd->stream, lcd->lcd_buf);
+  traced_mutex_give(&lcd->lcd_buf_lock);
+}
+
+static lv_obj_t *mon_label_create(lv_obj_t *scr, int x) {
+  lv_obj_t *label = lv_label_create(scr);
+  lv_obj_set_pos(label, x, 0);
+  lv_obj_set_style_text_font(label, &lv_font_unscii_8, 0);
+  lv_obj_set_style_text_color(label, lv_color_white(), 0);
+  lv_obj_set_style_text_line_space(label, 0, 0);
+  lv_label_set_text(label, "");
+  return label;
+}
+
+// 태스크별 이름, CPU 점유율 스파크라인, 최소 여유 스택을 보여주는 두 번째 화면
+static void setup_mon_ui(ssd1306_lcd_panel_t *lcd) {
+  lv_obj_t *scr = lv_obj_create(NULL);
+  lv_obj_set_style_bg_color(scr, lv_color_black(), 0);
+
+  lv_obj_t *canvas = lv_canvas_create(scr);
+  lv_obj_set_size(canvas, LCD_WIDTH, LCD_HEIGHT);
+  lv_obj_set_pos(canvas, 0, 0);
+  lv_canvas_set_buffer(canvas, lcd->mon_canvas_buf, LCD_WIDTH, LCD_HEIGHT,
+                       LV_COLOR_FORMAT_I1);
+  lv_canvas_set_palette(canvas, 0,
+                        lv_color_to_32(lv_color_black(), LV_OPA_COVER));
+  lv_canvas_set_palette(canvas, 1,
+                        lv_color_to_32(lv_color_white(), LV_OPA_COVER));
+  lv_canvas_fill_bg(canvas, lv_color_black(), LV_OPA_COVER);
+
+  lcd->mon_screen = scr;
+  lcd->mon_canvas = canvas;
+  lcd->mon_names = mon_label_create(scr, 0);
+  lcd->mon_stacks = mon_label_create(scr, MON_STACK_X);
+}
 
-void setup_lv_ui(ssd1306_lcd_panel_t *lcd) {
+void setup_lv_ui(ssd1306_lcd_panel_t *lcd, render_data_t *data) {
   lv_obj_t *scr = lv_display_get_screen_active(lcd->lv_disp);
+  lcd->main_screen = scr;
 
   lv_obj_t *stat = lv_label_create(scr);
-  lv_obj_set_user_data(stat, lcd);
   lv_obj_align(stat, LV_ALIGN_TOP_LEFT, 2, 2);
   lv_obj_set_style_text_color(stat, lv_color_white(), 0);
-  lv_label_set_text(stat, "M: -% T: -C");
-  lv_timer_create(update_label_cb, 1000, stat);
+  lv_label_set_text(stat, "M:-% F:-% -C");
+  lcd->stat_label = stat;
+
+#if PROF_ENABLED
+  if (PROF_OVERLAY) {
+    lv_obj_t *prof = lv_label_create(scr);
+    lv_obj_align(prof, LV_ALIGN_BOTTOM_LEFT, 2, -2);
+    lv_obj_set_style_text_color(prof, lv_color_white(), 0);
+    lv_label_set_text(prof, "-fps -ms");
+    lcd->prof_label = prof;
+  }
+#endif
 
+  // 렌더 태스크가 그린 1bpp 프레임을 그대로 복사할 수 있도록 I1 포맷 사용
   lv_obj_t *canvas = lv_canvas_create(scr);
-  render_data_t *data = setup_render_data(lcd);
   lv_obj_set_user_data(canvas, data);
   lv_obj_set_size(canvas, LCD_WIDTH, LCD_HEIGHT);
   lv_obj_set_pos(canvas, 0, 0);
   lv_canvas_set_buffer(canvas, lcd->canvas_buf, LCD_WIDTH, LCD_HEIGHT,
-                       LV_COLOR_FORMAT_ARGB8888);
+                       LV_COLOR_FORMAT_I1);
+  lv_canvas_set_palette(canvas, 0,
+                        lv_color_to_32(lv_color_black(), LV_OPA_COVER));
+  lv_canvas_set_palette(canvas, 1,
+                        lv_color_to_32(lv_color_white(), LV_OPA_COVER));
   lv_canvas_fill_bg(canvas, lv_color_black(), LV_OPA_COVER);
-  lv_timer_create(canvas_render_cb, 16, canvas);
+  lcd->canvas = canvas;
+  lcd->render = data;
 
   lv_obj_move_foreground(stat);
+  if (lcd->prof_label) lv_obj_move_foreground(lcd->prof_label);
+
+  setup_mon_ui(lcd);
 }
 
-static void update_label_cb(lv_timer_t *timer) {
-  char buf[16];
+// 센서 샘플링은 별도 태스크에서, 라벨 갱신은 메시지로 LVGL 태스크에 맡김
+void stats_task(void *pvParameters) {
+  ssd1306_lcd_panel_t *lcd = (ssd1306_lcd_panel_t *)pvParameters;
+  TickType_t xLastWakeTime = xTaskGetTickCount();
 
-  lv_obj_t *label = lv_timer_get_user_data(timer);
-  ssd1306_lcd_panel_t *lcd = lv_obj_get_user_data(label);
+  uint32_t since_report_ms = 0;
+#if SYSMON_SCREEN_CYCLE_MS > 0
+  uint32_t since_screen_ms = 0;
+  bool monitor = false;
+#endif
 
-  const size_t total_mem = heap_caps_get_total_size(MALLOC_CAP_8BIT);
-  const size_t free_mem = heap_caps_get_free_size(MALLOC_CAP_8BIT);
-  float temperature;
-  ESP_ERROR_CHECK(
-      temperature_sensor_get_celsius(lcd->temp_handle, &temperature));
+  while (true) {
+    heap_sample_t heap;
+    heap_sample(&heap);
+    ui_msg_t msg = {.type = UI_MSG_STATS};
+    msg.stats.mem_pct = heap.used_pct;
+    msg.stats.frag_pct = heap.frag_pct;
+    ESP_ERROR_CHECK(temperature_sensor_get_celsius(lcd->temp_handle,
+                                                   &msg.stats.temperature));
+    ui_msg_post(lcd->ui_queue, &msg);
+    traced_mutex_report(&lcd->lcd_buf_lock);
+    if (sysmon_poll(lcd->sysmon, STATS_PERIOD_MS)) {
+      msg.type = UI_MSG_SYSMON;
+      ui_msg_post(lcd->ui_queue, &msg);
+    }
+#if SYSMON_SCREEN_CYCLE_MS > 0
+    since_screen_ms += STATS_PERIOD_MS;
+    if (since_screen_ms >= SYSMON_SCREEN_CYCLE_MS) {
+      monitor = !monitor;
+      msg.type = UI_MSG_SCREEN;
+      msg.screen.monitor = monitor;
+      ui_msg_post(lcd->ui_queue, &msg);
+      since_screen_ms = 0;
+    }
+#endif
+    since_report_ms += STATS_PERIOD_MS;
+    if (since_report_ms >= HEAP_REPORT_PERIOD_MS) {
+      heap_tag_report(since_report_ms);
+      sysmon_report(lcd->sysmon);
+      if (lcd->stream) stream_report(lcd->stream, since_report_ms);
+      if (lcd->gray) gray_report(lcd->gray);
+      since_report_ms = 0;
+    }
+    trace_poll();
+    vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(STATS_PERIOD_MS));
+  }
+}
 
-  snprintf(buf, sizeof(buf), "M: %d%% T: %.0fC",
-           ((total_mem - free_mem) * 100) / (total_mem), temperature);
+static void log_ui_queue_stats(ui_msg_queue_t *q) {
+  if (q->latency_count == 0) return;
+  ESP_LOGI(TAG,
+           "ui queue: %" PRIu32 " msgs, latency avg %" PRId64 "us max %" PRId64
+           "us, %" PRIu32 " dropped",
+           q->latency_count, q->latency_total_us / q->latency_count,
+           q->latency_max_us, atomic_load(&q->dropped));
+  q->latency_count = 0;
+  q->latency_total_us = 0;
+  q->latency_max_us = 0;
+}
 
-  if (xSemaphoreTake(lcd->lvgl_mutex, pdMS_TO_TICKS(LV_UI_REFRESH_PERIOD_MS)) ==
-      pdTRUE) {
-    lv_label_set_text(label, buf);
-    xSemaphoreGive(lcd->lvgl_mutex);
-  } else {
-    ESP_LOGW(TAG, "Failed to take LVGL mutex");
+// 스파크라인은 캔버스 버퍼에 직접 그리고 라벨은 행마다 한 줄
+static void draw_monitor(ssd1306_lcd_panel_t *lcd) {
+  // stats_task는 샘플을 쓴 뒤 다음 주기까지 건드리지 않으므로 잠금 없이 읽음
+  const sysmon_t *mon = lcd->sysmon;
+  lv_draw_buf_t *draw_buf = lv_canvas_get_draw_buf(lcd->mon_canvas);
+  uint8_t *fb = draw_buf->data + LV_PALETTE_SIZE;
+  char names[MON_ROWS * 6 + 1], stacks[MON_ROWS * 6 + 1];
+  int names_len = 0, stacks_len = 0;
+  int row = 0;
+
+  raster_clear(fb);
+  for (uint32_t i = 0; i < mon->task_count && row < MON_ROWS; i++) {
+    const sysmon_task_t *t = &mon->tasks[i];
+    if (!t->alive) continue;
+    names_len += snprintf(names + names_len, sizeof(names) - names_len,
+                          "%.5s\n", t->name);
+    uint32_t free = t->stack_min_free;
+    if (free < 10000)
+      stacks_len += snprintf(stacks + stacks_len, sizeof(stacks) - stacks_len,
+                             "%5lu\n", (unsigned long)free);
+    else
+      stacks_len += snprintf(stacks + stacks_len, sizeof(stacks) - stacks_len,
+                             "%4luk\n", (unsigned long)free / 1024);
+
+    // 가장 오래된 샘플이 왼쪽, 행 높이 7px에 0~100%
+    int base = row * 8 + 7;
+    int prev_y = 0;
+    for (uint32_t age = 0; age < SYSMON_HISTORY && age < mon->samples;
+         age++) {
+      int x = MON_SPARK_X + SYSMON_HISTORY - 1 - age;
+      int y = base - sysmon_history(t, mon->samples, age) * 6 / 100;
+      if (age == 0)
+        raster_set_pixel(fb, x, y);
+      else
+        raster_line(fb, x, y, x + 1, prev_y);
+      prev_y = y;
+    }
+    row++;
+  }
+  lv_label_set_text(lcd->mon_names, names);
+  lv_label_set_text(lcd->mon_stacks, stacks);
+  lv_obj_invalidate(lcd->mon_canvas);
+}
+
+static void handle_ui_msg(ssd1306_lcd_panel_t *lcd, const ui_msg_t *msg) {
+  char buf[24];
+
+  switch (msg->type) {
+    case UI_MSG_STATS:
+      snprintf(buf, sizeof(buf), "M:%d%% F:%d%% %.0fC", msg->stats.mem_pct,
+               msg->stats.frag_pct, msg->stats.temperature);
+      lv_label_set_text(lcd->stat_label, buf);
+      log_ui_queue_stats(lcd->ui_queue);
+      break;
+    case UI_MSG_PROF:
+      if (!lcd->prof_label) break;
+      snprintf(buf, sizeof(buf), "%ufps %lu.%lums", msg->prof.fps,
+               (unsigned long)msg->prof.frame_us / 1000,
+               (unsigned long)msg->prof.frame_us / 100 % 10);
+      lv_label_set_text(lcd->prof_label, buf);
+      break;
+    case UI_MSG_SYSMON:
+      if (lv_screen_active() == lcd->mon_screen) draw_monitor(lcd);
+      break;
+    case UI_MSG_SCREEN:
+      if (msg->screen.monitor) draw_monitor(lcd);
+      lv_screen_load(msg->screen.monitor ? lcd->mon_screen : lcd->main_screen);
+      break;
+    default:
+      ESP_LOGW(TAG, "Unknown UI message: %d", msg->type);
+      break;
   }
 }
 
 void lv_timer_handler_task(void *pvParameters) {
-  __unused ssd1306_lcd_panel_t *lcd = (ssd1306_lcd_panel_t *)pvParameters;
-  TickType_t xLastWakeTime = xTaskGetTickCount();
+  ssd1306_lcd_panel_t *lcd = (ssd1306_lcd_panel_t *)pvParameters;
+  frame_sched_t *sched = lcd->render->sched;
+  ui_msg_t msg;
 
   while (true) {
+    frame_sched_wait_present(sched);
+    // 이 태스크만 LVGL 객체를 만지므로 mutex가 필요 없음
+    while (ui_msg_pop(lcd->ui_queue, &msg)) handle_ui_msg(lcd, &msg);
+    PROF_BEGIN(PROF_PRESENT);
+    bool fresh = render_present(lcd->render, lcd->canvas);
+    PROF_END(PROF_PRESENT);
+    frame_sched_presented(sched, fresh);
     lv_timer_handler();  // LVGL 메인 루프 호출
-    vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(LV_UI_REFRESH_PERIOD_MS));
+    PROF_BEGIN(PROF_LVGL_REFRESH);
+    lv_refr_now(lcd->lv_disp);  // 프레임당 한 번 갱신 및 flush
+    PROF_END(PROF_LVGL_REFRESH);
+    // lock을 못 잡아 버린 flush는 다음 갱신에서 다시 그림
+    if (lcd->flush_retry_pending) {
+      lcd->flush_retry_pending = false;
+      lv_obj_invalidate_area(lv_screen_active(), &lcd->flush_retry);
+    }
   }
 }
 
-static bool IRAM_ATTR lv_tick_timer_cb(gptimer_handle_t timer,
-                                       const gptimer_alarm_event_data_t *edata,
-                                       void *user_ctx) {
-  lv_tick_inc(LV_TICK_PERIOD_MS);
-  return true;
+static uint32_t lv_tick_cb(void) { return esp_timer_get_time() / 1000; }
+
+// SSD1306은 8행 단위 page로 쓰므로 무효 영역을 화면 폭 전체의 page 행으로 넓힘
+static void lvgl_rounder_cb(lv_event_t *e) {
+  lv_area_t *area = lv_event_get_param(e);
+  area->x1 = 0;
+  area->x2 = LCD_WIDTH - 1;
+  area->y1 &= ~7;
+  area->y2 |= 7;
 }
 
 static void lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area,
                           uint8_t *px_map) {
   ssd1306_lcd_panel_t *lcd = lv_display_get_user_data(disp);
 
-  if (xSemaphoreTake(lcd->lvgl_mutex, pdMS_TO_TICKS(LV_UI_REFRESH_PERIOD_MS)) !=
-      pdTRUE) {
-    lv_display_flush_ready(disp);
-    ESP_LOGW(TAG, "Failed to take LVGL mutex");
-    return;
-  }
-
   // skip palette
   px_map += LV_PALETTE_SIZE;
 
@@ -219,34 +433,41 @@ static void lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area,
   int y1 = area->y1;
   int y2 = area->y2;
 
-  // copy example code
-  for (int y = y1; y <= y2; y++) {
-    for (int x = x1; x <= x2; x++) {
-      /* The order of bits is MSB first
-                  MSB           LSB
-         bits      7 6 5 4 3 2 1 0
-         pixels    0 1 2 3 4 5 6 7
-                  Left         Right
-      */
-      bool chroma_color =
-          (px_map[(hor_res >> 3) * y + (x >> 3)] & 1 << (7 - x % 8));
-
-      /* Write to the buffer as required for the display.
-       * It writes only 1-bit for monochrome displays mapped vertically.*/
-      uint8_t *buf = lcd->lcd_buf + hor_res * (y >> 3) + (x);
-      // invert color
-      if (!chroma_color) {
-        (*buf) &= ~(1 << (y % 8));
-      } else {
-        (*buf) |= (1 << (y % 8));
-      }
+  if (!traced_mutex_take(&lcd->lcd_buf_lock,
+                         pdMS_TO_TICKS(LCD_BUF_LOCK_TIMEOUT_MS))) {
+    ESP_LOGW(TAG, "Failed to take lcd_buf lock");
+    // lcd_buf에 반영되지 않은 영역, 갱신 중에는 무효화할 수 없어 모아 둠
+    lv_area_t *retry = &lcd->flush_retry;
+    if (!lcd->flush_retry_pending) {
+      *retry = *area;
+      lcd->flush_retry_pending = true;
+    } else {
+      if (area->x1 < retry->x1) retry->x1 = area->x1;
+      if (area->y1 < retry->y1) retry->y1 = area->y1;
+      if (area->x2 > retry->x2) retry->x2 = area->x2;
+      if (area->y2 > retry->y2) retry->y2 = area->y2;
     }
+    lv_display_flush_ready(disp);
+    return;
+  }
+  PROF_BEGIN(PROF_FLUSH_CONVERT);
+  raster_to_pages(px_map, lcd->lcd_buf, x1, y1, x2, y2);
+  PROF_END(PROF_FLUSH_CONVERT);
+  if (lcd->gray) {
+    frame_rect_t overlay[2];
+    int count = canvas_overlay(lcd, overlay);
+    gray_flushed(lcd->gray, y1 >> 3, y2 >> 3, overlay, count);
   }
-  // draw with esp driver
+  // 영역이 page 행 단위로 맞춰져 있어 lcd_buf의 해당 page들이 연속된 데이터임,
+  // draw_bitmap의 끝 좌표는 포함하지 않음
+  PROF_BEGIN(PROF_FLUSH_XFER);
   ESP_ERROR_CHECK(esp_lcd_panel_draw_bitmap(
-      lcd->panel_handle, x1, y1, x2 - x1 + 1, y2 - y1 + 1, lcd->lcd_buf));
-  // unlock ui and lcd mutex
-  xSemaphoreGive(lcd->lvgl_mutex);
+      lcd->panel_handle, x1, y1, x2 + 1, y2 + 1,
+      lcd->lcd_buf + hor_res * (y1 >> 3)));
+  PROF_END(PROF_FLUSH_XFER);
+  if (lcd->stream && lv_display_flush_is_last(disp))
+    stream_submit(lcd->stream, lcd->lcd_buf);
+  traced_mutex_give(&lcd->lcd_buf_lock);
   // notify flush done
   lv_display_flush_ready(disp);
 }
@@ -1,7 +1,6 @@
 #ifndef __LCD_H__
 #define __LCD_H__
 
-#include "driver/gptimer.h"
 #include "driver/i2c_master.h"
 #include "driver/temperature_sensor.h"
 #include "esp_lcd_types.h"
@@ -9,6 +8,9 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "lvgl.h"
+#include "sysmon.h"
+#include "trace.h"
+#include "ui_msg.h"
 
 #define LCD_PIXEL_CLOCK_HZ (400 * 1000)
 #define LCD_PIN_NUM_SDA GPIO_NUM_8
@@ -24,30 +26,63 @@
 #define LV_PALETTE_SIZE 8
 #define LVGL_DRAW_BUF_SIZE (LCD_BUF_SIZE + LV_PALETTE_SIZE)
 
-#define LV_TICK_PERIOD_MS 8
 #define LV_TIMER_HANDLER_TASK_STACK_SIZE 8192
 #define LV_TIMER_HANDLER_TASK_PRIORITY 5
-#define LV_UI_REFRESH_PERIOD_MS 16
+
+#define STATS_TASK_STACK_SIZE 3072
+#define STATS_TASK_PRIORITY 2
+#define STATS_PERIOD_MS 1000
+#define LCD_BUF_LOCK_TIMEOUT_MS 100
+
+// sysmon screen, one 8px unscii row per task
+#define MON_ROWS (LCD_HEIGHT / 8)
+#define MON_SPARK_X 42
+#define MON_STACK_X 88
+
+typedef struct render_data_s render_data_t;
+typedef struct frame_stream_s frame_stream_t;
+typedef struct gray_sched_s gray_sched_t;
 
 typedef struct ssd1306_lcd_panel_s {
   temperature_sensor_handle_t temp_handle;
   i2c_master_bus_handle_t i2c_bus;
   esp_lcd_panel_io_handle_t io_handle;
   esp_lcd_panel_handle_t panel_handle;
-  gptimer_handle_t lv_tick_timer;
   lv_display_t *lv_disp;
   lv_theme_t *theme;
   uint8_t *lcd_buf;    // do not directly access this buffer except in flush_cb
   uint8_t *draw_buf0;  // do not directly access this buffer
   uint8_t *draw_buf1;  // do not directly access this buffer
   void *canvas_buf;    // do not directly access this buffer
-  SemaphoreHandle_t lcd_buf_mutex;
-  SemaphoreHandle_t lvgl_mutex;
+  traced_mutex_t lcd_buf_lock;
+  // flush dropped on a lcd_buf_lock timeout, lv_timer_handler_task
+  // invalidates it again after the refresh
+  lv_area_t flush_retry;
+  bool flush_retry_pending;
+  // LVGL objects are only touched by lv_timer_handler_task, other tasks post
+  // to ui_queue instead
+  ui_msg_queue_t *ui_queue;
+  lv_obj_t *stat_label;
+  lv_obj_t *prof_label;  // NULL unless PROF_OVERLAY
+  lv_obj_t *canvas;
+  render_data_t *render;
+  sysmon_t *sysmon;  // written by stats_task, drawn by lv_timer_handler_task
+  lv_obj_t *main_screen;
+  lv_obj_t *mon_screen;
+  lv_obj_t *mon_canvas;  // CPU sparklines
+  lv_obj_t *mon_names;
+  lv_obj_t *mon_stacks;
+  void *mon_canvas_buf;  // do not directly access this buffer
+  frame_stream_t *stream;  // NULL unless STREAM_ENABLED
+  gray_sched_t *gray;      // NULL unless GRAY_ENABLED
 } ssd1306_lcd_panel_t;
 
 ssd1306_lcd_panel_t *lcd_setup(void);
 void setup_lv_timer(ssd1306_lcd_panel_t *lcd);
-void setup_lv_ui(ssd1306_lcd_panel_t *lcd);
+uint8_t *lcd_pages_lock(ssd1306_lcd_panel_t *lcd);
+void lcd_pages_unlock(ssd1306_lcd_panel_t *lcd, uint8_t page_mask);
+void setup_lv_ui(ssd1306_lcd_panel_t *lcd, render_data_t *data);
 void lv_timer_handler_task(void *pvParameters);
+void stats_task(void *pvParameters);
 
 #endif  // __LCD_H__
\ No newline at end of file
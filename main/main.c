@@ -1,20 +1,54 @@
 #include <math.h>
 #include <stdio.h>
 
+#include "bench.h"
+#include "driver/gpio.h"
 #include "driver/i2c_master.h"
 #include "driver/temperature_sensor.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "gray.h"
 #include "lcd.h"
+#include "player.h"
 #include "render.h"
+#include "sdkconfig.h"
+#include "trace.h"
+
+// 점퍼로 BENCH_BOOT_GPIO를 GND에 묶고 켜면 UI를 띄우기 전에 벤치마크를 돌림
+static bool bench_requested(void) {
+  gpio_config_t cfg = {
+      .pin_bit_mask = 1ULL << BENCH_BOOT_GPIO,
+      .mode = GPIO_MODE_INPUT,
+      .pull_up_en = GPIO_PULLUP_ENABLE,
+  };
+  ESP_ERROR_CHECK(gpio_config(&cfg));
+  bool low = gpio_get_level(BENCH_BOOT_GPIO) == 0;
+  gpio_reset_pin(BENCH_BOOT_GPIO);
+  return low;
+}
 
 void app_main(void) {
+  trace_init();
   ssd1306_lcd_panel_t *lcd = lcd_setup();
+  if (VIDEO_PLAY_AT_BOOT) video_play(lcd, VIDEO_LOOPS);
+  render_data_t *data = setup_render_data(lcd);
+  // frame 커널이 앱과 같은 render_frame을 재도록 render data가 생긴 뒤에 돌림
+  if (bench_requested()) bench_run_all(stdout, CONFIG_IDF_TARGET, data);
   setup_lv_timer(lcd);
-  setup_lv_ui(lcd);
+  setup_lv_ui(lcd, data);
+  gray_start(lcd->gray);
+  TaskHandle_t render_handle, lvgl_handle, stats_handle;
+  xTaskCreate(render_task, "render_task", RENDER_TASK_STACK_SIZE, data,
+              RENDER_TASK_PRIORITY, &render_handle);
   xTaskCreate(lv_timer_handler_task, "lv_timer_handler_task",
               LV_TIMER_HANDLER_TASK_STACK_SIZE, lcd,
-              LV_TIMER_HANDLER_TASK_PRIORITY, NULL);
+              LV_TIMER_HANDLER_TASK_PRIORITY, &lvgl_handle);
+  frame_sched_start(data->sched, render_handle, lvgl_handle);
+  xTaskCreate(stats_task, "stats_task", STATS_TASK_STACK_SIZE, lcd,
+              STATS_TASK_PRIORITY, &stats_handle);
+  trace_register_task(render_handle);
+  trace_register_task(lvgl_handle);
+  trace_register_task(stats_handle);
   vTaskDelete(NULL);
 }
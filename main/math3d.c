@@ -0,0 +1,59 @@
+#include "math3d.h"
+
+#include <math.h>
+
+float recip_table[RECIP_TABLE_SIZE + 1];
+
+void recip_table_init(void) {
+  for (int i = 0; i <= RECIP_TABLE_SIZE; i++)
+    recip_table[i] = 1.0f / (1.0f + (float)i / RECIP_TABLE_SIZE);
+}
+
+vec3_t vec3_normalize(vec3_t v) {
+  float len = sqrtf(vec3_dot(v, v));
+  return (vec3_t){v.x / len, v.y / len, v.z / len};
+}
+
+mat3_t mat3_identity(void) {
+  return (mat3_t){{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}};
+}
+
+// Rz * Ry * Rx, x축 회전이 가장 먼저 적용됨
+mat3_t mat3_from_euler(float sx, float cx, float sy, float cy, float sz,
+                       float cz) {
+  return (mat3_t){{
+      {cz * cy, cz * sy * sx - sz * cx, cz * sy * cx + sz * sx},
+      {sz * cy, sz * sy * sx + cz * cx, sz * sy * cx - cz * sx},
+      {-sy, cy * sx, cy * cx},
+  }};
+}
+
+// Gram-Schmidt, 누적된 반올림 오차로 회전 행렬이 찌그러지는 것을 되돌림
+void mat3_orthonormalize(mat3_t *m) {
+  float *r0 = m->m[0], *r1 = m->m[1], *r2 = m->m[2];
+
+  float len = sqrtf(r0[0] * r0[0] + r0[1] * r0[1] + r0[2] * r0[2]);
+  for (int i = 0; i < 3; i++) r0[i] /= len;
+
+  float d = r0[0] * r1[0] + r0[1] * r1[1] + r0[2] * r1[2];
+  for (int i = 0; i < 3; i++) r1[i] -= d * r0[i];
+  len = sqrtf(r1[0] * r1[0] + r1[1] * r1[1] + r1[2] * r1[2]);
+  for (int i = 0; i < 3; i++) r1[i] /= len;
+
+  r2[0] = r0[1] * r1[2] - r0[2] * r1[1];
+  r2[1] = r0[2] * r1[0] - r0[0] * r1[2];
+  r2[2] = r0[0] * r1[1] - r0[1] * r1[0];
+}
+
+// max |M * M^T - I|
+float mat3_ortho_error(const mat3_t *m) {
+  float err = 0;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      float d = m->m[i][0] * m->m[j][0] + m->m[i][1] * m->m[j][1] +
+                m->m[i][2] * m->m[j][2] - (i == j ? 1.0f : 0.0f);
+      if (fabsf(d) > err) err = fabsf(d);
+    }
+  }
+  return err;
+}
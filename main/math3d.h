@@ -0,0 +1,109 @@
+#ifndef __MATH3D_H__
+#define __MATH3D_H__
+
+#include <stdint.h>
+#include <string.h>
+
+#define RECIP_TABLE_BITS 8
+#define RECIP_TABLE_SIZE (1 << RECIP_TABLE_BITS)
+
+typedef struct {
+  float x, y, z;
+} vec3_t;
+
+// row major, v' = m * v
+typedef struct {
+  float m[3][3];
+} mat3_t;
+
+// affine 3x4 (implicit last row 0 0 0 1), v' = m * (v, 1)
+typedef struct {
+  float m[3][4];
+} mat34_t;
+
+extern float recip_table[RECIP_TABLE_SIZE + 1];
+
+static inline vec3_t vec3_sub(vec3_t a, vec3_t b) {
+  return (vec3_t){a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+static inline float vec3_dot(vec3_t a, vec3_t b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+static inline vec3_t vec3_cross(vec3_t a, vec3_t b) {
+  return (vec3_t){a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z,
+                  a.x * b.y - a.y * b.x};
+}
+
+static inline vec3_t mat3_apply(const mat3_t *m, const vec3_t *v) {
+  return (vec3_t){
+      m->m[0][0] * v->x + m->m[0][1] * v->y + m->m[0][2] * v->z,
+      m->m[1][0] * v->x + m->m[1][1] * v->y + m->m[1][2] * v->z,
+      m->m[2][0] * v->x + m->m[2][1] * v->y + m->m[2][2] * v->z,
+  };
+}
+
+static inline mat3_t mat3_mul(const mat3_t *a, const mat3_t *b) {
+  mat3_t r;
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++)
+      r.m[i][j] = a->m[i][0] * b->m[0][j] + a->m[i][1] * b->m[1][j] +
+                  a->m[i][2] * b->m[2][j];
+  return r;
+}
+
+static inline vec3_t mat34_apply(const mat34_t *m, const vec3_t *v) {
+  return (vec3_t){
+      m->m[0][0] * v->x + m->m[0][1] * v->y + m->m[0][2] * v->z + m->m[0][3],
+      m->m[1][0] * v->x + m->m[1][1] * v->y + m->m[1][2] * v->z + m->m[1][3],
+      m->m[2][0] * v->x + m->m[2][1] * v->y + m->m[2][2] * v->z + m->m[2][3],
+  };
+}
+
+static inline mat34_t mat34_mul(const mat34_t *a, const mat34_t *b) {
+  mat34_t r;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 4; j++)
+      r.m[i][j] = a->m[i][0] * b->m[0][j] + a->m[i][1] * b->m[1][j] +
+                  a->m[i][2] * b->m[2][j];
+    r.m[i][3] += a->m[i][3];
+  }
+  return r;
+}
+
+static inline mat34_t mat34_from_rt(const mat3_t *r, vec3_t t) {
+  return (mat34_t){{
+      {r->m[0][0], r->m[0][1], r->m[0][2], t.x},
+      {r->m[1][0], r->m[1][1], r->m[1][2], t.y},
+      {r->m[2][0], r->m[2][1], r->m[2][2], t.z},
+  }};
+}
+
+/*
+ * 1/w without a division (the C3 has no FPU): split w into mantissa and
+ * exponent, look the mantissa up in a table over [1, 2] and rebuild the
+ * exponent. only valid for positive normal floats.
+ */
+static inline float fast_recip(float w) {
+  uint32_t bits;
+  memcpy(&bits, &w, sizeof(bits));
+  uint32_t idx = (bits >> (23 - RECIP_TABLE_BITS)) & (RECIP_TABLE_SIZE - 1);
+  float frac = (float)(bits & ((1 << (23 - RECIP_TABLE_BITS)) - 1)) *
+               (1.0f / (1 << (23 - RECIP_TABLE_BITS)));
+  float r = recip_table[idx] + (recip_table[idx + 1] - recip_table[idx]) * frac;
+  uint32_t scale_bits = (254 - (bits >> 23)) << 23;  // 2^-(e - 127)
+  float scale;
+  memcpy(&scale, &scale_bits, sizeof(scale));
+  return r * scale;
+}
+
+void recip_table_init(void);
+vec3_t vec3_normalize(vec3_t v);
+mat3_t mat3_identity(void);
+mat3_t mat3_from_euler(float sx, float cx, float sy, float cy, float sz,
+                       float cz);
+void mat3_orthonormalize(mat3_t *m);
+float mat3_ortho_error(const mat3_t *m);
+
+#endif  // __MATH3D_H__
@@ -0,0 +1,271 @@
+#include "mesh_import.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NO_FACE UINT32_MAX
+
+typedef struct {
+  uint32_t key;  // (min vertex << 16 | max vertex) + 1, 0 = empty slot
+  uint32_t face[2];
+  bool non_manifold;  // shared by more than two faces
+} edge_slot_t;
+
+static bool grow(void **ptr, uint32_t *cap, uint32_t need, size_t size) {
+  if (need <= *cap) return true;
+  uint32_t n = *cap ? *cap * 2 : 64;
+  while (n < need) n *= 2;
+  void *p = realloc(*ptr, n * size);
+  if (!p) return false;
+  *ptr = p;
+  *cap = n;
+  return true;
+}
+
+static const char *skip_space(const char *p, const char *end) {
+  while (p < end && (*p == ' ' || *p == '\t')) p++;
+  return p;
+}
+
+static const char *next_line(const char *p, const char *end) {
+  while (p < end && *p != '\n') p++;
+  return p < end ? p + 1 : end;
+}
+
+// "v/vt/vn" 형태에서 정점 번호만 읽음, 음수는 끝에서부터 센 번호
+static mesh_err_t parse_index(const char **p, const char *end,
+                              uint32_t vertex_count, uint32_t *out) {
+  char *num_end;
+  long idx = strtol(*p, &num_end, 10);
+  if (num_end == *p) return MESH_ERR_FORMAT;
+  *p = num_end;
+  while (*p < end && **p != ' ' && **p != '\t' && **p != '\n' && **p != '\r')
+    (*p)++;
+  if (idx < 0) idx += vertex_count + 1;
+  if (idx < 1 || idx > (long)vertex_count) return MESH_ERR_RANGE;
+  *out = idx - 1;
+  return MESH_OK;
+}
+
+/*
+ * v and f records only, everything else (vt, vn, groups, materials) is
+ * skipped. polygons are fan triangulated. the text does not need to be nul
+ * terminated but must not end in the middle of a number.
+ */
+mesh_err_t mesh_parse_obj(const char *text, size_t len, mesh_t *mesh) {
+  const char *p = text, *end = text + len;
+  uint32_t vcap = 0, fcap = 0;
+  memset(mesh, 0, sizeof(*mesh));
+
+  while (p < end) {
+    p = skip_space(p, end);
+    if (end - p > 2 && p[0] == 'v' && (p[1] == ' ' || p[1] == '\t')) {
+      uint32_t n = mesh->vertex_count;
+      if (n >= MESH_MAX_VERTICES) return MESH_ERR_RANGE;
+      // 세 배열이 같은 용량으로 함께 커짐
+      uint32_t xcap = vcap, ycap = vcap, zcap = vcap;
+      if (!grow((void **)&mesh->x, &xcap, n + 1, sizeof(float)) ||
+          !grow((void **)&mesh->y, &ycap, n + 1, sizeof(float)) ||
+          !grow((void **)&mesh->z, &zcap, n + 1, sizeof(float)))
+        return MESH_ERR_NO_MEM;
+      vcap = xcap;
+      char *num_end;
+      const char *q = p + 2;
+      float *dst[3] = {&mesh->x[n], &mesh->y[n], &mesh->z[n]};
+      for (int i = 0; i < 3; i++) {
+        *dst[i] = strtof(q, &num_end);
+        if (num_end == q) return MESH_ERR_FORMAT;
+        q = num_end;
+      }
+      mesh->vertex_count++;
+    } else if (end - p > 2 && p[0] == 'f' && (p[1] == ' ' || p[1] == '\t')) {
+      const char *q = p + 2;
+      uint32_t first = 0, prev = 0, idx, count = 0;
+      while (true) {
+        q = skip_space(q, end);
+        if (q >= end || *q == '\n' || *q == '\r' || *q == '#') break;
+        mesh_err_t err = parse_index(&q, end, mesh->vertex_count, &idx);
+        if (err != MESH_OK) return err;
+        if (count == 0) first = idx;
+        if (count >= 2) {
+          if (mesh->face_count >= MESH_MAX_FACES) return MESH_ERR_RANGE;
+          if (!grow((void **)&mesh->faces, &fcap, mesh->face_count + 1,
+                    sizeof(mesh->faces[0])))
+            return MESH_ERR_NO_MEM;
+          uint16_t *f = mesh->faces[mesh->face_count++];
+          f[0] = first;
+          f[1] = prev;
+          f[2] = idx;
+        }
+        prev = idx;
+        count++;
+      }
+      if (count < 3) return MESH_ERR_FORMAT;
+    }
+    p = next_line(p, end);
+  }
+  return MESH_OK;
+}
+
+static bool face_normal(const mesh_t *m, uint32_t f, float n[3]) {
+  const uint16_t *v = m->faces[f];
+  float ax = m->x[v[1]] - m->x[v[0]], ay = m->y[v[1]] - m->y[v[0]];
+  float az = m->z[v[1]] - m->z[v[0]];
+  float bx = m->x[v[2]] - m->x[v[0]], by = m->y[v[2]] - m->y[v[0]];
+  float bz = m->z[v[2]] - m->z[v[0]];
+  n[0] = ay * bz - az * by;
+  n[1] = az * bx - ax * bz;
+  n[2] = ax * by - ay * bx;
+  float len = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+  if (len < 1e-12f) return false;
+  for (int i = 0; i < 3; i++) n[i] /= len;
+  return true;
+}
+
+static edge_slot_t *edge_find(edge_slot_t *table, uint32_t mask,
+                              uint32_t key) {
+  // multiplicative hash, linear probing
+  uint32_t i = (key * 2654435761u) & mask;
+  while (table[i].key && table[i].key != key) i = (i + 1) & mask;
+  return &table[i];
+}
+
+/*
+ * unique edges through an open addressing hash table keyed by the vertex
+ * pair, each remembering the (up to two) faces that share it. an edge is
+ * kept when it is a boundary, non-manifold, touches a degenerate face or
+ * the faces meet at more than crease_deg; flat interior edges such as quad
+ * diagonals are dropped.
+ */
+mesh_err_t mesh_extract_edges(mesh_t *mesh, float crease_deg) {
+  uint32_t cap = 16;
+  while (cap < mesh->face_count * 3 * 2) cap *= 2;
+  edge_slot_t *table = calloc(cap, sizeof(edge_slot_t));
+  if (!table) return MESH_ERR_NO_MEM;
+
+  uint32_t unique = 0;
+  for (uint32_t f = 0; f < mesh->face_count; f++) {
+    for (int k = 0; k < 3; k++) {
+      uint32_t a = mesh->faces[f][k], b = mesh->faces[f][(k + 1) % 3];
+      if (a == b) continue;
+      uint32_t key = (a < b ? a << 16 | b : b << 16 | a) + 1;
+      edge_slot_t *e = edge_find(table, cap - 1, key);
+      if (!e->key) {
+        *e = (edge_slot_t){key, {f, NO_FACE}, false};
+        unique++;
+      } else if (e->face[1] == NO_FACE) {
+        e->face[1] = f;
+      } else {
+        e->non_manifold = true;
+      }
+    }
+  }
+
+  free(mesh->edges);
+  mesh->edges = malloc((unique ? unique : 1) * sizeof(mesh->edges[0]));
+  if (!mesh->edges) {
+    free(table);
+    return MESH_ERR_NO_MEM;
+  }
+  float cos_crease = cosf(crease_deg * (float)M_PI / 180);
+  mesh->edge_count = 0;
+  for (uint32_t i = 0; i < cap; i++) {
+    const edge_slot_t *e = &table[i];
+    if (!e->key) continue;
+    bool keep = e->non_manifold || e->face[1] == NO_FACE;
+    if (!keep) {
+      float n0[3], n1[3];
+      keep = !face_normal(mesh, e->face[0], n0) ||
+             !face_normal(mesh, e->face[1], n1) ||
+             n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2] < cos_crease;
+    }
+    if (!keep) continue;
+    if (mesh->edge_count >= MESH_MAX_EDGES) {
+      free(table);
+      return MESH_ERR_RANGE;
+    }
+    uint32_t key = e->key - 1;
+    mesh->edges[mesh->edge_count][0] = key >> 16;
+    mesh->edges[mesh->edge_count][1] = key & 0xffff;
+    mesh->edge_count++;
+  }
+  mesh->unique_edges = unique;
+  free(table);
+  return MESH_OK;
+}
+
+size_t mesh_blob_size(const mesh_t *mesh) {
+  return MESH_BLOB_HEADER_SIZE + mesh->vertex_count * 3 * sizeof(float) +
+         mesh->edge_count * 2 * sizeof(uint16_t) +
+         mesh->face_count * 3 * sizeof(uint16_t);
+}
+
+static uint8_t *put_u16(uint8_t *p, uint16_t v) {
+  p[0] = v;
+  p[1] = v >> 8;
+  return p + 2;
+}
+
+static uint8_t *put_f32(uint8_t *p, float f) {
+  uint32_t v;
+  memcpy(&v, &f, sizeof(v));
+  p = put_u16(p, v);
+  return put_u16(p, v >> 16);
+}
+
+void mesh_write_blob(const mesh_t *mesh, uint8_t *out) {
+  memcpy(out, MESH_BLOB_MAGIC, 4);
+  uint8_t *p = out + 4;
+  p = put_u16(p, mesh->vertex_count);
+  p = put_u16(p, mesh->edge_count);
+  p = put_u16(p, mesh->face_count);
+  p = put_u16(p, 0);
+  for (uint32_t i = 0; i < mesh->vertex_count; i++) p = put_f32(p, mesh->x[i]);
+  for (uint32_t i = 0; i < mesh->vertex_count; i++) p = put_f32(p, mesh->y[i]);
+  for (uint32_t i = 0; i < mesh->vertex_count; i++) p = put_f32(p, mesh->z[i]);
+  for (uint32_t i = 0; i < mesh->edge_count; i++) {
+    p = put_u16(p, mesh->edges[i][0]);
+    p = put_u16(p, mesh->edges[i][1]);
+  }
+  for (uint32_t i = 0; i < mesh->face_count; i++)
+    for (int k = 0; k < 3; k++) p = put_u16(p, mesh->faces[i][k]);
+}
+
+static uint16_t get_u16(const uint8_t *p) { return p[0] | p[1] << 8; }
+
+mesh_err_t mesh_read_blob(const uint8_t *data, size_t len, mesh_blob_t *blob) {
+  if (len < MESH_BLOB_HEADER_SIZE || memcmp(data, MESH_BLOB_MAGIC, 4))
+    return MESH_ERR_FORMAT;
+  blob->vertex_count = get_u16(data + 4);
+  blob->edge_count = get_u16(data + 6);
+  blob->face_count = get_u16(data + 8);
+
+  size_t vsize = blob->vertex_count * sizeof(float);
+  blob->x = data + MESH_BLOB_HEADER_SIZE;
+  blob->y = blob->x + vsize;
+  blob->z = blob->y + vsize;
+  blob->edges = blob->z + vsize;
+  blob->faces = blob->edges + blob->edge_count * 2 * sizeof(uint16_t);
+  if (blob->faces + blob->face_count * 3 * sizeof(uint16_t) != data + len)
+    return MESH_ERR_FORMAT;
+
+  // 잘못된 인덱스가 렌더러까지 가지 않도록 여기서 걸러냄
+  for (uint32_t i = 0; i < blob->edge_count * 2; i++)
+    if (get_u16(blob->edges + i * 2) >= blob->vertex_count)
+      return MESH_ERR_RANGE;
+  for (uint32_t i = 0; i < blob->face_count * 3; i++)
+    if (get_u16(blob->faces + i * 2) >= blob->vertex_count)
+      return MESH_ERR_RANGE;
+  return MESH_OK;
+}
+
+void mesh_free(mesh_t *mesh) {
+  free(mesh->x);
+  free(mesh->y);
+  free(mesh->z);
+  free(mesh->faces);
+  free(mesh->edges);
+  memset(mesh, 0, sizeof(*mesh));
+}
@@ -0,0 +1,63 @@
+#ifndef __MESH_IMPORT_H__
+#define __MESH_IMPORT_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * triangle mesh import for the wireframe renderer. portable (plain libc) so
+ * the same code runs in the host tool (tools/mesh_import.c) and on the
+ * device.
+ *
+ *   obj text -> mesh_parse_obj -> mesh_extract_edges -> mesh_write_blob
+ *
+ * the blob is the compact form the renderer loads (mesh_read_blob), all
+ * fields little endian:
+ *
+ *   "WFM1", u16 vertex_count, u16 edge_count, u16 face_count, u16 0
+ *   f32 x[vertex_count], y[vertex_count], z[vertex_count]
+ *   u16 edges[edge_count][2], faces[face_count][3]
+ */
+
+#define MESH_BLOB_MAGIC "WFM1"
+#define MESH_BLOB_HEADER_SIZE 12
+#define MESH_MAX_VERTICES 0xffff
+#define MESH_MAX_FACES 0xffff  // the header counts are u16
+#define MESH_MAX_EDGES 0xffff
+#define MESH_DEFAULT_CREASE_DEG 20.0f
+
+typedef enum {
+  MESH_OK = 0,
+  MESH_ERR_NO_MEM = -1,
+  MESH_ERR_FORMAT = -2,
+  MESH_ERR_RANGE = -3,  // index out of range or a count over 0xffff
+} mesh_err_t;
+
+typedef struct {
+  float *x, *y, *z;
+  uint16_t (*faces)[3];  // counter clockwise seen from outside (obj order)
+  uint16_t (*edges)[2];
+  uint32_t vertex_count;
+  uint32_t face_count;
+  uint32_t edge_count;
+  uint32_t unique_edges;  // before the crease filter
+} mesh_t;
+
+// unaligned views into a blob, copy out with memcpy
+typedef struct {
+  uint32_t vertex_count;
+  uint32_t edge_count;
+  uint32_t face_count;
+  const uint8_t *x, *y, *z;
+  const uint8_t *edges;
+  const uint8_t *faces;
+} mesh_blob_t;
+
+mesh_err_t mesh_parse_obj(const char *text, size_t len, mesh_t *mesh);
+mesh_err_t mesh_extract_edges(mesh_t *mesh, float crease_deg);
+size_t mesh_blob_size(const mesh_t *mesh);
+void mesh_write_blob(const mesh_t *mesh, uint8_t *out);
+mesh_err_t mesh_read_blob(const uint8_t *data, size_t len, mesh_blob_t *blob);
+void mesh_free(mesh_t *mesh);
+
+#endif  // __MESH_IMPORT_H__
@@ -0,0 +1,61 @@
+#include "packbits.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#define RUN_MIN 3
+#define RUN_MAX 130
+#define LITERAL_MAX 128
+
+static bool run_starts(const uint8_t *src, size_t i, size_t len) {
+  return i + 2 < len && src[i] == src[i + 1] && src[i] == src[i + 2];
+}
+
+size_t packbits_pack(const uint8_t *src, size_t len, uint8_t *out) {
+  uint8_t *o = out;
+  size_t i = 0;
+  while (i < len) {
+    if (run_starts(src, i, len)) {
+      size_t run = RUN_MIN;
+      while (i + run < len && run < RUN_MAX && src[i + run] == src[i]) run++;
+      *o++ = run + 125;
+      *o++ = src[i];
+      i += run;
+      continue;
+    }
+    // 다음 반복 구간이 나올 때까지 리터럴로 묶음
+    size_t lit = 1;
+    while (i + lit < len && lit < LITERAL_MAX && !run_starts(src, i + lit, len))
+      lit++;
+    *o++ = lit - 1;
+    memcpy(o, src + i, lit);
+    o += lit;
+    i += lit;
+  }
+  return o - out;
+}
+
+// 입력이 dst_len을 정확히 채우지 않으면 0, 아니면 읽은 바이트 수
+size_t packbits_unpack_xor(const uint8_t *src, size_t len, uint8_t *dst,
+                           size_t dst_len) {
+  size_t i = 0, o = 0;
+  while (o < dst_len) {
+    if (i >= len) return 0;
+    uint8_t n = src[i++];
+    if (n < LITERAL_MAX) {
+      size_t lit = n + 1;
+      if (i + lit > len || o + lit > dst_len) return 0;
+      for (size_t k = 0; k < lit; k++) dst[o + k] ^= src[i + k];
+      i += lit;
+      o += lit;
+    } else {
+      size_t run = n - 125;
+      if (i >= len || o + run > dst_len) return 0;
+      uint8_t v = src[i++];
+      if (v)
+        for (size_t k = 0; k < run; k++) dst[o + k] ^= v;
+      o += run;
+    }
+  }
+  return i;
+}
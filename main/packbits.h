@@ -0,0 +1,21 @@
+#ifndef __PACKBITS_H__
+#define __PACKBITS_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * packbits run length coding for 1bpp page data, portable (plain libc) for
+ * the host tools. a header byte n < 128 is followed by n + 1 literal bytes,
+ * n >= 128 by one byte repeated n - 125 times (3..130). XOR deltas between
+ * frames are mostly zero runs, so unpacking XORs into the destination and
+ * skips zero runs without touching it.
+ */
+
+#define PACKBITS_MAX_SIZE(len) ((len) + ((len) + 127) / 128)
+
+size_t packbits_pack(const uint8_t *src, size_t len, uint8_t *out);
+size_t packbits_unpack_xor(const uint8_t *src, size_t len, uint8_t *dst,
+                           size_t dst_len);
+
+#endif  // __PACKBITS_H__
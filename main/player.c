@@ -0,0 +1,89 @@
+#include "player.h"
+
+#include <inttypes.h>
+
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define TAG "PLAYER"
+
+static bool play(ssd1306_lcd_panel_t *lcd, video_t *v, uint32_t loops) {
+  int64_t period_us = 1000000 / v->info.fps;
+  int64_t due_us = esp_timer_get_time();
+  int64_t decode_us = 0, flush_us = 0;
+  uint32_t frames = 0, late = 0;
+
+  for (uint32_t loop = 0; loop < loops; loop++) {
+    video_rewind(v);
+    while (true) {
+      uint8_t *pages = lcd_pages_lock(lcd);
+      if (!pages) return false;
+      int64_t start = esp_timer_get_time();
+      int mask = video_next(v, pages);
+      int64_t decoded = esp_timer_get_time();
+      if (mask < 0) {
+        lcd_pages_unlock(lcd, 0);
+        if (mask == VIDEO_ERR_END) break;
+        ESP_LOGE(TAG, "Corrupt frame %" PRIu32, v->frame);
+        return false;
+      }
+      lcd_pages_unlock(lcd, mask);
+      int64_t now = esp_timer_get_time();
+      decode_us += decoded - start;
+      flush_us += now - decoded;
+      frames++;
+
+      // 늦은 프레임도 delta라 건너뛸 수 없음, 기준 시각만 다시 맞춤
+      due_us += period_us;
+      if (now > due_us) {
+        late++;
+        due_us = now;
+      } else {
+        vTaskDelay(pdMS_TO_TICKS((due_us - now) / 1000));
+      }
+    }
+  }
+  if (frames)
+    ESP_LOGI(TAG,
+             "%" PRIu32 " frames, decode %" PRId64 " us, flush %" PRId64
+             " us per frame, %" PRIu32 " late",
+             frames, decode_us / frames, flush_us / frames, late);
+  return true;
+}
+
+bool video_play(ssd1306_lcd_panel_t *lcd, uint32_t loops) {
+  const esp_partition_t *part = esp_partition_find_first(
+      ESP_PARTITION_TYPE_DATA, VIDEO_PARTITION_SUBTYPE, VIDEO_PARTITION_LABEL);
+  if (!part) {
+    ESP_LOGI(TAG, "No %s partition", VIDEO_PARTITION_LABEL);
+    return false;
+  }
+  const void *data;
+  esp_partition_mmap_handle_t handle;
+  esp_err_t err = esp_partition_mmap(part, 0, part->size,
+                                     ESP_PARTITION_MMAP_DATA, &data, &handle);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to map %s: 0x%x", part->label, err);
+    return false;
+  }
+
+  video_t v;
+  video_err_t verr = video_open(&v, data, part->size, LCD_WIDTH, LCD_HEIGHT);
+  bool ok = false;
+  if (verr == VIDEO_OK) {
+    ESP_LOGI(TAG, "%" PRIu32 " frames at %u fps, %" PRIu32 " bytes",
+             v.info.frame_count, v.info.fps, v.info.data_size);
+    ok = play(lcd, &v, loops);
+  } else if (verr == VIDEO_ERR_SIZE) {
+    ESP_LOGW(TAG, "Video is %ux%u, the panel %ux%u", v.info.width,
+             v.info.height, LCD_WIDTH, LCD_HEIGHT);
+  } else {
+    // 지워진 플래시는 0xff라 매직이 맞지 않음
+    ESP_LOGI(TAG, "No video in %s", part->label);
+  }
+  esp_partition_munmap(handle);
+  return ok;
+}
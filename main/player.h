@@ -0,0 +1,25 @@
+#ifndef __PLAYER_H__
+#define __PLAYER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "lcd.h"
+#include "video.h"
+
+/*
+ * plays a video.h container from the "video" data partition before the
+ * render pipeline starts. the partition is mmapped, frames decode straight
+ * into lcd_buf and only the page rows a frame changed go to the panel.
+ * write a video with tools/video_encode, the build flashes video.wfv from
+ * the project directory when it exists.
+ */
+
+#define VIDEO_PLAY_AT_BOOT true  // quietly skipped when no video is flashed
+#define VIDEO_LOOPS 1
+#define VIDEO_PARTITION_LABEL "video"
+#define VIDEO_PARTITION_SUBTYPE 0x40  // first custom data subtype
+
+bool video_play(ssd1306_lcd_panel_t *lcd, uint32_t loops);
+
+#endif  // __PLAYER_H__
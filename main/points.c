@@ -0,0 +1,79 @@
+#include "points.h"
+
+#include <math.h>
+
+#include "heap_tag.h"
+#include "xform.h"
+
+// range: 가장 큰 좌표의 절댓값, int16 전체 범위에 맞춰 양자화 간격을 정함
+bool point_cloud_init(point_cloud_t *pc, uint32_t count, float range) {
+  pc->x = heap_tag_calloc(HEAP_TAG_RENDER, count, sizeof(int16_t),
+                          MALLOC_CAP_8BIT);
+  pc->y = heap_tag_calloc(HEAP_TAG_RENDER, count, sizeof(int16_t),
+                          MALLOC_CAP_8BIT);
+  pc->z = heap_tag_calloc(HEAP_TAG_RENDER, count, sizeof(int16_t),
+                          MALLOC_CAP_8BIT);
+  if (!pc->x || !pc->y || !pc->z) {
+    point_cloud_free(pc);
+    return false;
+  }
+  pc->count = count;
+  pc->scale = range / INT16_MAX;
+  pc->step = 1;
+  pc->phase = 0;
+  pc->budget_us = 0;
+  pc->plotted = 0;
+  return true;
+}
+
+static int16_t quantize(float v, float scale) {
+  float q = roundf(v / scale);
+  if (q > INT16_MAX) return INT16_MAX;
+  if (q < -INT16_MAX) return -INT16_MAX;
+  return q;
+}
+
+void point_cloud_set(point_cloud_t *pc, uint32_t i, vec3_t v) {
+  pc->x[i] = quantize(v.x, pc->scale);
+  pc->y[i] = quantize(v.y, pc->scale);
+  pc->z[i] = quantize(v.z, pc->scale);
+}
+
+void point_cloud_draw(point_cloud_t *pc, const mat34_t *mvp, float near,
+                      uint8_t *fb, int width, int height) {
+  // 역양자화 배율을 행렬의 회전 부분에 미리 곱해 점마다 곱셈을 하지 않음
+  mat34_t m = *mvp;
+  for (int r = 0; r < 3; r++)
+    for (int c = 0; c < 3; c++) m.m[r][c] *= pc->scale;
+
+  uint32_t phase = pc->phase < pc->count ? pc->phase : 0;
+  pc->plotted = xform_plot_points(&m, pc->x + phase, pc->y + phase,
+                                  pc->z + phase, pc->count - phase, pc->step,
+                                  near, fb, width, height);
+  pc->phase = (pc->phase + 1) % pc->step;
+}
+
+/*
+ * one step per frame towards the budget. the step only shrinks when the
+ * denser frame is predicted to fit, so it does not oscillate around the
+ * limit.
+ */
+void point_cloud_adapt(point_cloud_t *pc, uint32_t elapsed_us) {
+  if (pc->budget_us == 0) return;
+  if (elapsed_us > pc->budget_us) {
+    if (pc->step < POINTS_MAX_STEP) pc->step++;
+  } else if (pc->step > 1 &&
+             (uint64_t)elapsed_us * pc->step / (pc->step - 1) <
+                 pc->budget_us) {
+    pc->step--;
+  }
+  if (pc->phase >= pc->step) pc->phase = 0;
+}
+
+void point_cloud_free(point_cloud_t *pc) {
+  heap_tag_free(HEAP_TAG_RENDER, pc->x);
+  heap_tag_free(HEAP_TAG_RENDER, pc->y);
+  heap_tag_free(HEAP_TAG_RENDER, pc->z);
+  pc->x = pc->y = pc->z = NULL;
+  pc->count = 0;
+}
@@ -0,0 +1,40 @@
+#ifndef __POINTS_H__
+#define __POINTS_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "math3d.h"
+
+/*
+ * point cloud primitive for sensor data. positions are quantized to int16
+ * (world = q * scale), 6 bytes per point instead of 12, and plotted as
+ * single pixels by xform_plot_points.
+ *
+ * when a frame takes longer than the budget only every step-th point is
+ * drawn, starting at a phase that rotates each frame so all points still
+ * show up over `step` frames.
+ */
+
+#define POINTS_MAX_STEP 8
+
+typedef struct {
+  int16_t *x;
+  int16_t *y;
+  int16_t *z;
+  uint32_t count;
+  float scale;  // world units per quantization step
+  uint16_t step;
+  uint16_t phase;
+  uint32_t budget_us;  // 0: never decimate
+  uint32_t plotted;    // pixels set by the last draw
+} point_cloud_t;
+
+bool point_cloud_init(point_cloud_t *pc, uint32_t count, float range);
+void point_cloud_set(point_cloud_t *pc, uint32_t i, vec3_t v);
+void point_cloud_draw(point_cloud_t *pc, const mat34_t *mvp, float near,
+                      uint8_t *fb, int width, int height);
+void point_cloud_adapt(point_cloud_t *pc, uint32_t elapsed_us);
+void point_cloud_free(point_cloud_t *pc);
+
+#endif  // __POINTS_H__
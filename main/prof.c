@@ -0,0 +1,74 @@
+#include "prof.h"
+
+#if PROF_ENABLED
+
+#include <stdio.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+#define CYCLES_PER_US CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ
+
+typedef struct {
+  uint32_t samples[PROF_WINDOW];  // cycles
+  uint32_t next;                  // total samples ever recorded
+  uint32_t reported;              // `next` at the last report
+} prof_window_t;
+
+static const char *const stage_names[PROF_STAGE_COUNT] = {
+    [PROF_RENDER_FRAME] = "render",   [PROF_DRAW_OBJECTS] = "draw",
+    [PROF_PRESENT] = "present",       [PROF_LVGL_REFRESH] = "refresh",
+    [PROF_FLUSH_CONVERT] = "convert", [PROF_FLUSH_XFER] = "xfer",
+};
+
+static prof_window_t windows[PROF_STAGE_COUNT];
+static bool header_done = false;
+
+void prof_record(prof_stage_t stage, uint32_t cycles) {
+  prof_window_t *w = &windows[stage];
+  w->samples[w->next & (PROF_WINDOW - 1)] = cycles;
+  w->next++;
+}
+
+void prof_stats(prof_stage_t stage, prof_stats_t *out) {
+  prof_window_t *w = &windows[stage];
+  uint32_t next = w->next;
+  uint32_t n = next < PROF_WINDOW ? next : PROF_WINDOW;
+  memset(out, 0, sizeof(*out));
+  out->count = next - w->reported;
+  if (n == 0) return;
+
+  // 리포트할 때만 정렬, 삽입 정렬이면 128개 정도는 충분히 빠름
+  uint32_t sorted[PROF_WINDOW];
+  uint64_t sum = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    uint32_t v = w->samples[i];
+    uint32_t j = i;
+    for (; j > 0 && sorted[j - 1] > v; j--) sorted[j] = sorted[j - 1];
+    sorted[j] = v;
+    sum += v;
+  }
+  out->min_us = sorted[0] / CYCLES_PER_US;
+  out->max_us = sorted[n - 1] / CYCLES_PER_US;
+  out->avg_us = sum / n / CYCLES_PER_US;
+  out->p99_us = sorted[(n * 99 + 99) / 100 - 1] / CYCLES_PER_US;
+}
+
+// 콘솔 로그와 섞여도 grep '^prof,'로 뽑아낼 수 있는 CSV, count는 여기서 리셋됨
+void prof_report(void) {
+  if (!header_done) {
+    printf("prof,stage,count,min_us,avg_us,max_us,p99_us\n");
+    header_done = true;
+  }
+  for (int i = 0; i < PROF_STAGE_COUNT; i++) {
+    prof_stats_t s;
+    prof_stats(i, &s);
+    windows[i].reported += s.count;
+    printf("prof,%s,%lu,%lu,%lu,%lu,%lu\n", stage_names[i],
+           (unsigned long)s.count, (unsigned long)s.min_us,
+           (unsigned long)s.avg_us, (unsigned long)s.max_us,
+           (unsigned long)s.p99_us);
+  }
+}
+
+#endif  // PROF_ENABLED
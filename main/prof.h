@@ -0,0 +1,62 @@
+#ifndef __PROF_H__
+#define __PROF_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * per-stage frame profiler. a scope reads the CPU cycle counter on entry and
+ * exit and stores the difference in the stage's rolling window; min, avg,
+ * max and p99 are only computed when reporting. each stage is written by a
+ * single task, reports from another task may see a sample being replaced,
+ * which only shifts the statistics by one frame.
+ *
+ * with PROF_ENABLED 0 the scopes expand to nothing and prof.c is empty.
+ * release builds leave it off, idf.py -DPROF=ON and the tools/sim build
+ * turn it on.
+ */
+
+#ifndef PROF_ENABLED
+#define PROF_ENABLED 0
+#endif
+#define PROF_OVERLAY true  // fps/ms label next to the stats label
+#define PROF_WINDOW 128    // samples per stage, must be a power of two
+
+typedef enum {
+  PROF_RENDER_FRAME,   // render task, clear to publish
+  PROF_DRAW_OBJECTS,   // draw_object for every object
+  PROF_PRESENT,        // render_present, frame -> canvas
+  PROF_LVGL_REFRESH,   // lv_refr_now including the flush
+  PROF_FLUSH_CONVERT,  // lvgl_flush_cb row major -> page conversion
+  PROF_FLUSH_XFER,     // esp_lcd_panel_draw_bitmap
+  PROF_STAGE_COUNT,
+} prof_stage_t;
+
+typedef struct {
+  uint32_t min_us, avg_us, max_us, p99_us;
+  uint32_t count;  // samples since the last prof_report
+} prof_stats_t;
+
+#if PROF_ENABLED
+
+#include "esp_cpu.h"
+
+#define PROF_BEGIN(stage) \
+  const uint32_t prof_start_##stage = esp_cpu_get_cycle_count()
+#define PROF_END(stage) \
+  prof_record(stage, esp_cpu_get_cycle_count() - prof_start_##stage)
+
+void prof_record(prof_stage_t stage, uint32_t cycles);
+void prof_stats(prof_stage_t stage, prof_stats_t *out);
+void prof_report(void);
+
+#else
+
+#define PROF_BEGIN(stage) (void)0
+#define PROF_END(stage) (void)0
+
+static inline void prof_report(void) {}
+
+#endif  // PROF_ENABLED
+
+#endif  // __PROF_H__
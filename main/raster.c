@@ -0,0 +1,144 @@
+#include "raster.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "heap_tag.h"
+
+#define TAG "RASTER"
+#define CHECK_ALLOC(ptr)                                    \
+  do {                                                      \
+    if (ptr == NULL) {                                      \
+      ESP_LOGE(TAG, "Failed to allocate memory: %s", #ptr); \
+      abort();                                              \
+    }                                                       \
+  } while (0)
+
+void raster_clear(uint8_t *fb) { memset(fb, 0, LCD_BUF_SIZE); }
+
+void raster_set_pixel(uint8_t *fb, int x, int y) {
+  if ((unsigned)x >= LCD_WIDTH || (unsigned)y >= LCD_HEIGHT) return;
+  fb[y * RASTER_STRIDE + (x >> 3)] |= 0x80 >> (x & 7);
+}
+
+// Bresenham, 화면 밖 픽셀은 raster_set_pixel에서 버림
+void raster_line(uint8_t *fb, int x0, int y0, int x1, int y1) {
+  // 양 끝점이 같은 쪽으로 화면 밖이면 그릴 것이 없음
+  if ((x0 < 0 && x1 < 0) || (y0 < 0 && y1 < 0) ||
+      (x0 >= LCD_WIDTH && x1 >= LCD_WIDTH) ||
+      (y0 >= LCD_HEIGHT && y1 >= LCD_HEIGHT))
+    return;
+
+  int dx = abs(x1 - x0);
+  int dy = -abs(y1 - y0);
+  int sx = x0 < x1 ? 1 : -1;
+  int sy = y0 < y1 ? 1 : -1;
+  int err = dx + dy;
+
+  while (true) {
+    raster_set_pixel(fb, x0, y0);
+    if (x0 == x1 && y0 == y1) break;
+    int e2 = 2 * err;
+    if (e2 >= dy) {
+      err += dy;
+      x0 += sx;
+    }
+    if (e2 <= dx) {
+      err += dx;
+      y0 += sy;
+    }
+  }
+}
+
+// 음수 좌표도 내림이 되도록 바이트 위치와 비트 위치로 나눔
+static inline int byte_of(int px) {
+  return px >= 0 ? px >> 3 : -((-px + 7) >> 3);
+}
+
+// fb의 (x, y, w, h) 영역을 1bpp 스프라이트로 복사, 영역은 화면 안이어야 함
+void raster_copy_rect(const uint8_t *fb, int x, int y, int w, int h,
+                      uint8_t *dst, int dst_stride) {
+  int sh = x & 7;
+  uint8_t tail = 0xff << (dst_stride * 8 - w);
+  for (int r = 0; r < h; r++) {
+    const uint8_t *row = fb + (y + r) * RASTER_STRIDE;
+    for (int k = 0; k < dst_stride; k++) {
+      int idx = (x >> 3) + k;
+      uint8_t v = row[idx] << sh;
+      if (sh && idx + 1 < RASTER_STRIDE) v |= row[idx + 1] >> (8 - sh);
+      dst[r * dst_stride + k] = k == dst_stride - 1 ? v & tail : v;
+    }
+  }
+}
+
+// 스프라이트를 (x, y)에 OR로 합성, 화면 밖 부분은 잘라냄
+void raster_blit(uint8_t *fb, const uint8_t *src, int src_stride, int h,
+                 int x, int y) {
+  int bx = byte_of(x);
+  int sh = x - bx * 8;
+  // 화면 안에 들어오는 출력 바이트 bx + k 범위만 돌도록 미리 자름
+  int k0 = bx < 0 ? -bx : 0;
+  int k1 = RASTER_STRIDE - bx < src_stride ? RASTER_STRIDE - bx : src_stride;
+  int r0 = y < 0 ? -y : 0;
+  int r1 = LCD_HEIGHT - y < h ? LCD_HEIGHT - y : h;
+
+  for (int r = r0; r < r1; r++) {
+    uint8_t *row = fb + (y + r) * RASTER_STRIDE;
+    const uint8_t *s = src + r * src_stride;
+    if (sh == 0) {
+      // 바이트 정렬이면 그대로 OR
+      for (int k = k0; k < k1; k++) row[bx + k] |= s[k];
+      continue;
+    }
+    // 왼쪽으로 잘린 바이트의 아래쪽 비트는 k0 위치로 넘어옴
+    if (k0 > 0 && k0 <= src_stride) row[bx + k0] |= s[k0 - 1] << (8 - sh);
+    for (int k = k0; k < k1; k++) {
+      row[bx + k] |= s[k] >> sh;
+      if (bx + k + 1 < RASTER_STRIDE) row[bx + k + 1] |= s[k] << (8 - sh);
+    }
+  }
+}
+
+void raster_tile_capture(raster_tile_t *tile, uint8_t *scratch, int x, int y,
+                         int w, int h) {
+  tile->x = x;
+  tile->y = y;
+  tile->width = w > 0 ? w : 0;
+  tile->height = h > 0 ? h : 0;
+  tile->stride = (tile->width + 7) / 8;
+  uint32_t size = tile->stride * tile->height;
+  if (size == 0) return;
+  if (size > tile->size) {
+    heap_tag_free(HEAP_TAG_RENDER, tile->bits);
+    tile->bits = heap_tag_malloc(HEAP_TAG_RENDER, size, MALLOC_CAP_8BIT);
+    CHECK_ALLOC(tile->bits);
+    tile->size = size;
+  }
+  raster_copy_rect(scratch, x, y, w, h, tile->bits, tile->stride);
+  // 다음 타일을 위해 사용한 행만 지워 scratch를 빈 상태로 유지
+  memset(scratch + y * RASTER_STRIDE, 0, h * RASTER_STRIDE);
+}
+
+void raster_tile_blit(uint8_t *fb, const raster_tile_t *tile) {
+  if (tile->width == 0 || tile->height == 0) return;
+  raster_blit(fb, tile->bits, tile->stride, tile->height, tile->x, tile->y);
+}
+
+/*
+ * SSD1306 page layout: one byte per column covering 8 rows, bit n is row
+ * 8 * page + n. converts the inclusive rect of a row major frame into it.
+ */
+void raster_to_pages(const uint8_t *fb, uint8_t *pages, int x1, int y1,
+                     int x2, int y2) {
+  for (int y = y1; y <= y2; y++) {
+    for (int x = x1; x <= x2; x++) {
+      bool lit = fb[RASTER_STRIDE * y + (x >> 3)] & 1 << (7 - x % 8);
+      uint8_t *buf = pages + LCD_WIDTH * (y >> 3) + x;
+      if (lit)
+        *buf |= 1 << (y % 8);
+      else
+        *buf &= ~(1 << (y % 8));
+    }
+  }
+}
@@ -0,0 +1,37 @@
+#ifndef __RASTER_H__
+#define __RASTER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "lcd.h"
+
+// 1bpp, row major, MSB first (same layout as LV_COLOR_FORMAT_I1 without the
+// palette) so a finished frame can be copied straight into the canvas
+#define RASTER_STRIDE (LCD_WIDTH / 8)
+
+// 1bpp image of a screen region, same bit layout as the frame
+typedef struct {
+  uint8_t *bits;
+  uint32_t size;  // allocated bytes, grows to the largest capture
+  int16_t x;
+  int16_t y;
+  uint8_t width;
+  uint8_t height;
+  uint8_t stride;
+} raster_tile_t;
+
+void raster_clear(uint8_t *fb);
+void raster_set_pixel(uint8_t *fb, int x, int y);
+void raster_line(uint8_t *fb, int x0, int y0, int x1, int y1);
+void raster_copy_rect(const uint8_t *fb, int x, int y, int w, int h,
+                      uint8_t *dst, int dst_stride);
+void raster_blit(uint8_t *fb, const uint8_t *src, int src_stride, int h,
+                 int x, int y);
+void raster_tile_capture(raster_tile_t *tile, uint8_t *scratch, int x, int y,
+                         int w, int h);
+void raster_tile_blit(uint8_t *fb, const raster_tile_t *tile);
+void raster_to_pages(const uint8_t *fb, uint8_t *pages, int x1, int y1,
+                     int x2, int y2);
+
+#endif  // __RASTER_H__
@@ -1,9 +1,16 @@
 #include "render.h"
 
+#include <inttypes.h>
 #include <math.h>
 #include <string.h>
 
+#include "esp_timer.h"
+#include "fill.h"
+#include "heap_tag.h"
 #include "lcd.h"
+#include "mesh_import.h"
+#include "prof.h"
+#include "raster.h"
 #define TAG "RENDER"
 #define CHECK_ALLOC(ptr)                                    \
   do {                                                      \
@@ -13,151 +20,264 @@
     }                                                       \
   } while (0)
 
-static void cube_init(object3d_t *obj, vec3_t *offset, vec3_t *rotate);
-static void cone_init(object3d_t *obj, vec3_t *offset, vec3_t *rotate);
-static void cylinder_init(object3d_t *obj, vec3_t *offset, vec3_t *rotate);
-static void sphere_init(object3d_t *obj, vec3_t *offset, vec3_t *rotate);
-static void draw_object(lv_layer_t *layer, render_data_t *data,
-                        object3d_t *object);
-static void inline project_vertex(vec3_t *vertex, vec3_t *camera_pos, float fov,
-                                  float *px, float *py);
-static void inline rotate_vertex(vec3_t *vertex, vec3_t *rotation);
-static void inline rotate_x(vec3_t *vertex, float angle);
-static void inline rotate_y(vec3_t *vertex, float angle);
-static void inline rotate_z(vec3_t *vertex, float angle);
+static void draw_object(uint8_t *fb, render_data_t *data, object3d_t *object,
+                        frame_rect_t *dirty);
+static void animate_object(render_data_t *data, object3d_t *object,
+                           int64_t t_us);
+static void vertex_soa_alloc(vertex_soa_t *soa, uint32_t count);
+static void face_alloc(object3d_t *obj, uint32_t count);
+static void mesh_object_load(object3d_t *obj, const uint8_t *data,
+                             size_t len);
+static void face_add(object3d_t *obj, uint16_t a, uint16_t b, uint16_t c);
+static void face_add_quad(object3d_t *obj, uint16_t a, uint16_t b,
+                          uint16_t c, uint16_t d);
+static void face_finish(object3d_t *obj, bool orient);
+static void edge_faces_build(object3d_t *obj);
+static void sort_objects(render_data_t *data);
+static void report_impostors(render_data_t *data);
+static void points_init(render_data_t *data);
+#if PROF_ENABLED
+static void post_prof_overlay(render_data_t *data);
+#endif
+static void animate_points(render_data_t *data, int64_t t_us);
+static void draw_points(uint8_t *fb, render_data_t *data,
+                        frame_rect_t *dirty);
+#if RENDER_XFORM_BENCH
+static void xform_bench(render_data_t *data);
+#endif
 
 render_data_t *setup_render_data(ssd1306_lcd_panel_t *lcd) {
-  render_data_t *data =
-      heap_caps_calloc(1, sizeof(render_data_t), MALLOC_CAP_8BIT);
+  render_data_t *data = heap_tag_calloc(HEAP_TAG_RENDER, 1,
+                                        sizeof(render_data_t), MALLOC_CAP_8BIT);
   CHECK_ALLOC(data);
   data->lcd = lcd;
-  data->camera_pos = (vec3_t){0.0, 0.0, -8.0};
-  data->camera_dir = (vec3_t){0.0, 0.0, 1.0};
-  data->fov = FOV;
-  data->objects =
-      heap_caps_calloc(OBJECT_COUNT, sizeof(object3d_t), MALLOC_CAP_8BIT);
+  data->gray = lcd ? lcd->gray : NULL;
+  // 흑백 plane 두 장을 한 프레임으로 넘김, 채우기 모드는 자체 디더를 씀
+  data->gray_mode = data->gray && RENDER_MODE != RENDER_FILLED;
+  data->frames = frame_tribuf_create(data->gray_mode ? 2 : 1);
+  data->sched = frame_sched_create(FRAME_TARGET_FPS);
+  camera_init(&data->camera, LCD_WIDTH, LCD_HEIGHT, FOV);
+  camera_set_pos(&data->camera, (vec3_t){0.0, 0.0, -8.0});
+  camera_look_at(&data->camera, (vec3_t){0.0, 0.0, 0.0});
+  data->objects = heap_tag_calloc(HEAP_TAG_RENDER, OBJECT_COUNT,
+                                  sizeof(object3d_t), MALLOC_CAP_8BIT);
   CHECK_ALLOC(data->objects);
   data->object_count = OBJECT_COUNT;
+  data->transform_mode = RENDER_TRANSFORM_MODE;
+  anim_clock_init(&data->clock, NULL);
+  scene_init(&data->scene);
+  data->scene_root = scene_add_node(&data->scene, SCENE_NO_PARENT);
 
-  cube_init(data->objects, &(vec3_t){-4.0, 0.0, 0.0}, &(vec3_t){0.0, 0.0, 0.0});
-  cone_init(data->objects + 1, &(vec3_t){-4.0 / 3, 0.0, 0.0},
-            &(vec3_t){0.0, 0.0, 0.0});
-  cylinder_init(data->objects + 2, &(vec3_t){4.0 / 3, 0.0, 0.0},
-                &(vec3_t){0.0, 0.0, 0.0});
-  sphere_init(data->objects + 3, &(vec3_t){4.0, 0.0, 0.0},
-              &(vec3_t){0.0, 0.0, 0.0});
+  object3d_cube_init(data->objects);
+  object3d_cone_init(data->objects + 1);
+  object3d_cylinder_init(data->objects + 2);
+  object3d_sphere_init(data->objects + 3, SPHERE_LATITUDE_COUNT,
+                       SPHERE_LONGITUDE_COUNT);
+  data->objects[0].offset = (vec3_t){-4.0, 0.0, 0.0};
+  data->objects[1].offset = (vec3_t){-4.0 / 3, 0.0, 0.0};
+  data->objects[2].offset = (vec3_t){4.0 / 3, 0.0, 0.0};
+  data->objects[3].offset = (vec3_t){4.0, 0.0, 0.0};
+
+  // 예전 16ms 타이머 기준 프레임당 회전량을 초당 각속도로 환산
+  for (int i = 0; i < data->object_count; i++) {
+    object3d_t *obj = &data->objects[i];
+    anim_spin_init(&obj->spin, (0.1 + i * 0.01) / 0.016,
+                   (0.03 + i * 0.01) / 0.016, (0.02 + i * 0.01) / 0.016);
+    obj->spin.phase[0] = anim_rad_to_bam(obj->rotation.x);
+    obj->spin.phase[1] = anim_rad_to_bam(obj->rotation.y);
+    obj->spin.phase[2] = anim_rad_to_bam(obj->rotation.z);
+    rotation_init(&obj->rot, obj->spin.phase);
+    obj->node = scene_add_node(&data->scene, data->scene_root);
+    scene_set_local(&data->scene, obj->node, &obj->rot.orient, obj->offset,
+                    1.0f);
+  }
+
+  static anim_track_t sphere_lift;
+  static const anim_key_t sphere_lift_keys[] = {
+      {0.0, 0.0}, {0.25, 0.4}, {0.5, 0.0}, {0.75, -0.4}};
+  anim_track_build(&sphere_lift, sphere_lift_keys,
+                   sizeof(sphere_lift_keys) / sizeof(sphere_lift_keys[0]),
+                   ANIM_TRACK_MAX_SAMPLES, SPHERE_LIFT_PERIOD_US);
+  data->objects[3].lift = &sphere_lift;
+
+  // 객체마다 지난 프레임의 투영 결과를 보관
+  for (int i = 0; i < data->object_count; i++) {
+    object3d_t *obj = &data->objects[i];
+    obj->screen_xy = heap_tag_calloc(HEAP_TAG_RENDER, obj->verts.count * 2,
+                                     sizeof(int16_t), MALLOC_CAP_8BIT);
+    CHECK_ALLOC(obj->screen_xy);
+    if (data->gray_mode) {
+      obj->gray_level = heap_tag_calloc(HEAP_TAG_RENDER, obj->verts.count,
+                                        sizeof(uint8_t), MALLOC_CAP_8BIT);
+      CHECK_ALLOC(obj->gray_level);
+    }
+    obj->drawn = FRAME_RECT_EMPTY;
+    edge_faces_build(obj);
+  }
+  data->scratch = heap_tag_calloc(HEAP_TAG_RENDER, LCD_BUF_SIZE,
+                                  sizeof(uint8_t), MALLOC_CAP_8BIT);
+  CHECK_ALLOC(data->scratch);
+
+  data->render_mode = RENDER_MODE;
+  for (int i = 0; i < data->object_count; i++) data->draw_order[i] = i;
+  if (data->render_mode == RENDER_FILLED) render_fill_init(data);
+  data->impostor_mode = RENDER_IMPOSTOR_MODE;
+  if (data->impostor_mode) {
+    impostor_cache_init(&data->impostors, IMPOSTOR_CACHE_BUDGET);
+    // 스프라이트는 오일러 각도로 굽고 찾으므로, 캐시를 놓친 프레임의 직접
+    // 그리기도 같은 자세여야 물체가 튀지 않음
+    data->transform_mode = TRANSFORM_EULER;
+  }
+  data->points_mode = RENDER_POINT_CLOUD;
+  if (data->points_mode) points_init(data);
+
+#if RENDER_XFORM_BENCH
+  xform_bench(data);
+#endif
 
   return data;
 }
 
-void canvas_render_cb(lv_timer_t *timer) {
-  lv_obj_t *canvas = lv_timer_get_user_data(timer);
-  render_data_t *data = lv_obj_get_user_data(canvas);
-  if (xSemaphoreTake(data->lcd->lvgl_mutex,
-                     pdMS_TO_TICKS(LV_UI_REFRESH_PERIOD_MS)) != pdTRUE) {
-    ESP_LOGW(TAG, "Failed to take LVGL mutex");
-    return;
+// 한 프레임을 그려 triple buffer에 넘김, 시각은 data->clock에서 옴
+void render_frame(render_data_t *data) {
+  PROF_BEGIN(PROF_RENDER_FRAME);
+  uint8_t *fb = frame_tribuf_back(data->frames);
+  frame_rect_t dirty = FRAME_RECT_EMPTY;
+  if (data->gray_mode && !gray_active(data->gray)) {
+    // 1bpp로 돌아감, 타일은 흑백 모드 동안 갱신되지 않았으니 다시 그리게 함
+    data->gray_mode = false;
+    for (int i = 0; i < data->object_count; i++)
+      data->objects[i].proj_valid = false;
   }
-  lv_canvas_fill_bg(canvas, lv_color_black(), LV_OPA_COVER);
+  raster_clear(fb);
+  if (data->gray_mode) raster_clear(fb + LCD_BUF_SIZE);
 
-  lv_layer_t layer;
-  lv_canvas_init_layer(canvas, &layer);
+  // 움직임은 프레임 수가 아니라 절대 시간으로 결정됨
+  int64_t t_us = anim_clock_update(&data->clock);
+  camera_update(&data->camera);
+  for (int i = 0; i < data->object_count; i++)
+    animate_object(data, &data->objects[i], t_us);
+  if (data->points_mode) animate_points(data, t_us);
+  scene_update(&data->scene);
+  if (data->render_mode == RENDER_FILLED) {
+    fill_target_t target = {fb, data->coverage, LCD_WIDTH, LCD_HEIGHT};
+    fill_clear_coverage(&target);
+    sort_objects(data);
+  }
+  PROF_BEGIN(PROF_DRAW_OBJECTS);
+  for (int i = 0; i < data->object_count; i++)
+    draw_object(fb, data, &data->objects[data->draw_order[i]], &dirty);
+  PROF_END(PROF_DRAW_OBJECTS);
+  if (data->points_mode) draw_points(fb, data, &dirty);
 
-  for (int i = 0; i < data->object_count; i++) {
-    draw_object(&layer, data, &data->objects[i]);
-    data->objects[i].rotation.x += 0.1 + i * 0.01;
-    data->objects[i].rotation.y += 0.03 + i * 0.01;
-    data->objects[i].rotation.z += 0.02 + i * 0.01;
-    if (data->objects[i].rotation.x > 2 * M_PI)
-      data->objects[i].rotation.x -= 2 * M_PI;
-    if (data->objects[i].rotation.y > 2 * M_PI)
-      data->objects[i].rotation.y -= 2 * M_PI;
-    if (data->objects[i].rotation.z > 2 * M_PI)
-      data->objects[i].rotation.z -= 2 * M_PI;
-  }
-
-  lv_canvas_finish_layer(canvas, &layer);
-
-  xSemaphoreGive(data->lcd->lvgl_mutex);
-}
-
-static void cube_init(object3d_t *obj, vec3_t *offset, vec3_t *rotate) {
-  obj->vertices =
-      heap_caps_calloc(CUBE_VERTEX_COUNT, sizeof(vec3_t), MALLOC_CAP_8BIT);
-  CHECK_ALLOC(obj->vertices);
-  obj->vertices[0] = (vec3_t){-1, -1, -1};
-  obj->vertices[1] = (vec3_t){1, -1, -1};
-  obj->vertices[2] = (vec3_t){1, 1, -1};
-  obj->vertices[3] = (vec3_t){-1, 1, -1};
-  obj->vertices[4] = (vec3_t){-1, -1, 1};
-  obj->vertices[5] = (vec3_t){1, -1, 1};
-  obj->vertices[6] = (vec3_t){1, 1, 1};
-  obj->vertices[7] = (vec3_t){-1, 1, 1};
-  obj->vertex_count = CUBE_VERTEX_COUNT;
-  obj->edges = heap_caps_calloc(12, sizeof(uint8_t[2]), MALLOC_CAP_8BIT);
-  CHECK_ALLOC(obj->edges);
-  obj->edges[0][0] = 0;
-  obj->edges[0][1] = 1;
-  obj->edges[1][0] = 1;
-  obj->edges[1][1] = 2;
-  obj->edges[2][0] = 2;
-  obj->edges[2][1] = 3;
-  obj->edges[3][0] = 3;
-  obj->edges[3][1] = 0;
-  obj->edges[4][0] = 4;
-  obj->edges[4][1] = 5;
-  obj->edges[5][0] = 5;
-  obj->edges[5][1] = 6;
-  obj->edges[6][0] = 6;
-  obj->edges[6][1] = 7;
-  obj->edges[7][0] = 7;
-  obj->edges[7][1] = 4;
-  obj->edges[8][0] = 0;
-  obj->edges[8][1] = 4;
-  obj->edges[9][0] = 1;
-  obj->edges[9][1] = 5;
-  obj->edges[10][0] = 2;
-  obj->edges[10][1] = 6;
-  obj->edges[11][0] = 3;
-  obj->edges[11][1] = 7;
-  obj->edge_count = CUBE_EDGE_COUNT;
-  obj->offset = *offset;
-  obj->rotation = *rotate;
-}
-
-static void cone_init(object3d_t *obj, vec3_t *offset, vec3_t *rotate) {
-  obj->vertices =
-      heap_caps_calloc(CONE_SIDES + 1, sizeof(vec3_t), MALLOC_CAP_8BIT);
-  CHECK_ALLOC(obj->vertices);
-  obj->vertices[CONE_SIDES] = (vec3_t){0, 2, 0};  // 꼭짓점
-  obj->edges =
-      heap_caps_calloc(CONE_SIDES * 2, sizeof(uint8_t[2]), MALLOC_CAP_8BIT);
+  frame_tribuf_publish(data->frames, &dirty);
+  PROF_END(PROF_RENDER_FRAME);
+}
+
+void render_task(void *pvParameters) {
+  render_data_t *data = (render_data_t *)pvParameters;
+  // 목표 fps가 바뀌어도 보고는 1초마다, 프레임 수가 아니라 경과 시간으로
+  int64_t reported_us = esp_timer_get_time();
+  uint32_t frames = 0;
+
+  while (true) {
+    frame_sched_wait_render(data->sched);
+    render_frame(data);
+    frame_sched_rendered(data->sched);
+    frames++;
+    int64_t now = esp_timer_get_time();
+    if (now - reported_us >= RENDER_REPORT_PERIOD_US) {
+      reported_us = now;
+      frame_sched_report(data->sched, data->frames);
+      uint32_t lookups = data->proj_hits + data->proj_misses;
+      ESP_LOGI(TAG, "projection cache: %" PRIu32 "/%" PRIu32 " hits (%" PRIu32
+               "%%)", data->proj_hits, lookups,
+               lookups ? data->proj_hits * 100 / lookups : 0);
+      data->proj_hits = data->proj_misses = 0;
+      ESP_LOGD(TAG, "edges: %" PRIu32 "/%" PRIu32 " rasterized",
+               data->edges_drawn, data->edges_total);
+      data->edges_drawn = data->edges_total = 0;
+      if (data->impostor_mode) report_impostors(data);
+      if (data->points_mode) {
+        ESP_LOGI(TAG, "points: %" PRIu32 " plotted, 1/%u decimation, %" PRId64
+                 " us/frame", data->points.plotted, data->points.step,
+                 data->points_us / frames);
+        data->points_us = 0;
+      }
+#if PROF_ENABLED
+      if (PROF_OVERLAY) post_prof_overlay(data);
+#endif
+      prof_report();
+      if (data->transform_mode == TRANSFORM_INCREMENTAL)
+        ESP_LOGD(TAG, "rotation drift before renormalization: %e",
+                 data->ortho_error_max);
+      frames = 0;
+    }
+  }
+}
+
+// LVGL 태스크에서 실행, 가장 최근에 완성된 프레임을 락 없이 가져온다
+bool render_present(render_data_t *data, lv_obj_t *canvas) {
+  bool fresh;
+  frame_rect_t dirty;
+  const uint8_t *frame = frame_tribuf_acquire(data->frames, &fresh, &dirty);
+  if (!fresh) return false;
+  if (frame_rect_is_empty(&dirty)) return true;
+
+  // 바뀐 행만 복사하고 그 영역만 다시 그리게 함
+  lv_draw_buf_t *draw_buf = lv_canvas_get_draw_buf(canvas);
+  uint32_t offset = dirty.y1 * RASTER_STRIDE;
+  lv_memcpy(draw_buf->data + LV_PALETTE_SIZE + offset, frame + offset,
+            (dirty.y2 - dirty.y1 + 1) * RASTER_STRIDE);
+  lv_area_t area = {dirty.x1, dirty.y1, dirty.x2, dirty.y2};
+  lv_obj_invalidate_area(canvas, &area);
+  // 캔버스에는 plane 0만 가고 plane 1과의 차이는 gray_task가 번갈아 보여줌
+  if (data->gray_mode)
+    gray_submit(data->gray, frame, frame + LCD_BUF_SIZE, dirty.y1, dirty.y2);
+  return true;
+}
+
+// tools/mesh_import로 models/cube.obj에서 만든 블롭, CMake EMBED_FILES로 링크됨
+extern const uint8_t cube_wfm_start[] asm("_binary_cube_wfm_start");
+extern const uint8_t cube_wfm_end[] asm("_binary_cube_wfm_end");
+
+void object3d_cube_init(object3d_t *obj) {
+  mesh_object_load(obj, cube_wfm_start, cube_wfm_end - cube_wfm_start);
+}
+
+void object3d_cone_init(object3d_t *obj) {
+  vertex_soa_alloc(&obj->verts, CONE_SIDES + 1);
+  vertex_soa_set(&obj->verts, CONE_SIDES, (vec3_t){0, 2, 0});  // 꼭짓점
+  obj->edges = heap_tag_calloc(HEAP_TAG_RENDER, CONE_SIDES * 2,
+                               sizeof(uint16_t[2]), MALLOC_CAP_8BIT);
   CHECK_ALLOC(obj->edges);
   for (int i = 0; i < CONE_SIDES; i++) {
     float angle = i * 2 * M_PI / CONE_SIDES;
-    obj->vertices[i] = (vec3_t){cos(angle), -1, sin(angle)};
+    vertex_soa_set(&obj->verts, i, (vec3_t){cos(angle), -1, sin(angle)});
     obj->edges[i][0] = i;
     obj->edges[i][1] = (i + 1) % CONE_SIDES;
     obj->edges[CONE_SIDES + i][0] = i;
     obj->edges[CONE_SIDES + i][1] = CONE_SIDES;
   }
-  obj->vertex_count = CONE_SIDES + 1;
   obj->edge_count = CONE_SIDES * 2;
-  obj->offset = *offset;
-  obj->rotation = *rotate;
+  // 옆면과 밑면(부채꼴 분할)
+  face_alloc(obj, CONE_SIDES * 2 - 2);
+  for (int i = 0; i < CONE_SIDES; i++)
+    face_add(obj, i, (i + 1) % CONE_SIDES, CONE_SIDES);
+  for (int i = 1; i < CONE_SIDES - 1; i++) face_add(obj, 0, i, i + 1);
+  face_finish(obj, true);
 }
 
-static void cylinder_init(object3d_t *obj, vec3_t *offset, vec3_t *rotate) {
-  obj->vertices =
-      heap_caps_calloc(CYLINDER_SIDES * 2, sizeof(vec3_t), MALLOC_CAP_8BIT);
-  CHECK_ALLOC(obj->vertices);
-  obj->edges =
-      heap_caps_calloc(CYLINDER_SIDES * 3, sizeof(uint8_t[2]), MALLOC_CAP_8BIT);
+void object3d_cylinder_init(object3d_t *obj) {
+  vertex_soa_alloc(&obj->verts, CYLINDER_SIDES * 2);
+  obj->edges = heap_tag_calloc(HEAP_TAG_RENDER, CYLINDER_SIDES * 3,
+                               sizeof(uint16_t[2]), MALLOC_CAP_8BIT);
   CHECK_ALLOC(obj->edges);
   for (int i = 0; i < CYLINDER_SIDES; i++) {
     float angle = i * 2 * M_PI / CYLINDER_SIDES;
-    obj->vertices[i] = (vec3_t){cos(angle), -1, sin(angle)};
-    obj->vertices[CYLINDER_SIDES + i] = (vec3_t){cos(angle), 1, sin(angle)};
+    vertex_soa_set(&obj->verts, i, (vec3_t){cos(angle), -1, sin(angle)});
+    vertex_soa_set(&obj->verts, CYLINDER_SIDES + i,
+                   (vec3_t){cos(angle), 1, sin(angle)});
     obj->edges[i][0] = i;
     obj->edges[i][1] = (i + 1) % CYLINDER_SIDES;
     obj->edges[CYLINDER_SIDES + i][0] = CYLINDER_SIDES + i;
@@ -166,157 +286,668 @@ static void cylinder_init(object3d_t *obj, vec3_t *offset, vec3_t *rotate) {
     obj->edges[2 * CYLINDER_SIDES + i][0] = i;
     obj->edges[2 * CYLINDER_SIDES + i][1] = CYLINDER_SIDES + i;
   }
-  obj->vertex_count = CYLINDER_SIDES * 2;
   obj->edge_count = CYLINDER_SIDES * 3;
-  obj->offset = *offset;
-  obj->rotation = *rotate;
-}
-
-static void sphere_init(object3d_t *obj, vec3_t *offset, vec3_t *rotate) {
-  obj->vertices =
-      heap_caps_calloc(SPHERE_LATITUDE_COUNT * SPHERE_LONGITUDE_COUNT,
-                       sizeof(vec3_t), MALLOC_CAP_8BIT);
-  CHECK_ALLOC(obj->vertices);
-  obj->edges =
-      heap_caps_calloc(SPHERE_LATITUDE_COUNT * SPHERE_LONGITUDE_COUNT * 2,
-                       sizeof(uint8_t[2]), MALLOC_CAP_8BIT);
+  face_alloc(obj, CYLINDER_SIDES * 4 - 4);
+  for (int i = 0; i < CYLINDER_SIDES; i++) {
+    int j = (i + 1) % CYLINDER_SIDES;
+    face_add_quad(obj, i, j, CYLINDER_SIDES + j, CYLINDER_SIDES + i);
+  }
+  for (int i = 1; i < CYLINDER_SIDES - 1; i++) {
+    face_add(obj, 0, i, i + 1);
+    face_add(obj, CYLINDER_SIDES, CYLINDER_SIDES + i, CYLINDER_SIDES + i + 1);
+  }
+  face_finish(obj, true);
+}
+
+// lat: 극점을 포함한 위도 고리 수, 고리마다 정점 lon개
+void object3d_sphere_init(object3d_t *obj, int lat, int lon) {
+  int n = lat * lon;  // 뒤쪽 절반의 선분 번호 오프셋
+  vertex_soa_alloc(&obj->verts, n);
+  obj->edges = heap_tag_calloc(HEAP_TAG_RENDER, n * 2, sizeof(uint16_t[2]),
+                               MALLOC_CAP_8BIT);
   CHECK_ALLOC(obj->edges);
-  for (int i = 0; i < SPHERE_LATITUDE_COUNT; i++) {
-    float theta = i * M_PI / (SPHERE_LATITUDE_COUNT - 1);
-    for (int j = 0; j < SPHERE_LONGITUDE_COUNT; j++) {
-      float phi = j * 2 * M_PI / SPHERE_LONGITUDE_COUNT;
-      obj->vertices[i * SPHERE_LONGITUDE_COUNT + j] =
-          (vec3_t){sin(theta) * cos(phi), sin(theta) * sin(phi), cos(theta)};
+  for (int i = 0; i < lat; i++) {
+    float theta = i * M_PI / (lat - 1);
+    for (int j = 0; j < lon; j++) {
+      float phi = j * 2 * M_PI / lon;
+      vertex_soa_set(
+          &obj->verts, i * lon + j,
+          (vec3_t){sin(theta) * cos(phi), sin(theta) * sin(phi), cos(theta)});
       if (i > 0) {
-        obj->edges[(i - 1) * SPHERE_LONGITUDE_COUNT + j][0] =
-            (i - 1) * SPHERE_LONGITUDE_COUNT + j;
-        obj->edges[(i - 1) * SPHERE_LONGITUDE_COUNT + j][1] =
-            i * SPHERE_LONGITUDE_COUNT + j;
-        obj->edges[(i - 1) * SPHERE_LONGITUDE_COUNT + j +
-                   SPHERE_LATITUDE_COUNT * SPHERE_LONGITUDE_COUNT][0] =
-            (i - 1) * SPHERE_LONGITUDE_COUNT + j;
-        obj->edges[(i - 1) * SPHERE_LONGITUDE_COUNT + j +
-                   SPHERE_LATITUDE_COUNT * SPHERE_LONGITUDE_COUNT][1] =
-            (i - 1) * SPHERE_LONGITUDE_COUNT + (j + 1) % SPHERE_LONGITUDE_COUNT;
+        obj->edges[(i - 1) * lon + j][0] = (i - 1) * lon + j;
+        obj->edges[(i - 1) * lon + j][1] = i * lon + j;
+        obj->edges[(i - 1) * lon + j + n][0] = (i - 1) * lon + j;
+        obj->edges[(i - 1) * lon + j + n][1] = (i - 1) * lon + (j + 1) % lon;
+      }
+    }
+    obj->edges[i * lon][0] = i * lon + lon - 1;
+    obj->edges[i * lon][1] = i * lon;
+    obj->edges[i * lon + n][0] = i * lon;
+    obj->edges[i * lon + n][1] = i * lon + 1;
+
+    obj->edges[(i + 1) * lon - 1][0] = i * lon + lon - 1;
+    obj->edges[(i + 1) * lon - 1][1] = i * lon;
+    obj->edges[(i + 1) * lon - 1 + n][0] = i * lon + lon - 1;
+    obj->edges[(i + 1) * lon - 1 + n][1] = i * lon + lon - 2;
+  }
+  obj->edge_count = n * 2;
+  // 극점 쪽 사각형은 두 정점이 겹쳐 face_finish에서 한 삼각형만 남음
+  face_alloc(obj, (lat - 1) * lon * 2);
+  for (int i = 0; i < lat - 1; i++) {
+    for (int j = 0; j < lon; j++) {
+      int k = (j + 1) % lon;
+      face_add_quad(obj, i * lon + j, i * lon + k, (i + 1) * lon + k,
+                    (i + 1) * lon + j);
+    }
+  }
+  face_finish(obj, true);
+}
+
+/*
+ * copy a mesh blob (see mesh_import.h) into the object. the blob carries its
+ * own feature edges and keeps the obj winding, so imported meshes do not
+ * have to be convex.
+ */
+static void mesh_object_load(object3d_t *obj, const uint8_t *data,
+                             size_t len) {
+  mesh_blob_t blob;
+  mesh_err_t err = mesh_read_blob(data, len, &blob);
+  if (err != MESH_OK) {
+    ESP_LOGE(TAG, "Invalid mesh blob: %d", err);
+    abort();
+  }
+  vertex_soa_alloc(&obj->verts, blob.vertex_count);
+  memcpy(obj->verts.x, blob.x, blob.vertex_count * sizeof(float));
+  memcpy(obj->verts.y, blob.y, blob.vertex_count * sizeof(float));
+  memcpy(obj->verts.z, blob.z, blob.vertex_count * sizeof(float));
+  obj->edges = heap_tag_calloc(HEAP_TAG_RENDER,
+                               blob.edge_count ? blob.edge_count : 1,
+                               sizeof(uint16_t[2]), MALLOC_CAP_8BIT);
+  CHECK_ALLOC(obj->edges);
+  // 블롭은 리틀 엔디언이고 C3도 리틀 엔디언이라 그대로 복사
+  memcpy(obj->edges, blob.edges, blob.edge_count * sizeof(uint16_t[2]));
+  obj->edge_count = blob.edge_count;
+  face_alloc(obj, blob.face_count ? blob.face_count : 1);
+  memcpy(obj->faces, blob.faces, blob.face_count * sizeof(uint16_t[3]));
+  obj->face_count = blob.face_count;
+  face_finish(obj, false);
+}
+
+static void vertex_soa_alloc(vertex_soa_t *soa, uint32_t count) {
+  soa->x =
+      heap_tag_calloc(HEAP_TAG_RENDER, count, sizeof(float), MALLOC_CAP_8BIT);
+  CHECK_ALLOC(soa->x);
+  soa->y =
+      heap_tag_calloc(HEAP_TAG_RENDER, count, sizeof(float), MALLOC_CAP_8BIT);
+  CHECK_ALLOC(soa->y);
+  soa->z =
+      heap_tag_calloc(HEAP_TAG_RENDER, count, sizeof(float), MALLOC_CAP_8BIT);
+  CHECK_ALLOC(soa->z);
+  soa->count = count;
+}
+
+static void face_alloc(object3d_t *obj, uint32_t count) {
+  obj->faces = heap_tag_calloc(HEAP_TAG_RENDER, count, sizeof(uint16_t[3]),
+                               MALLOC_CAP_8BIT);
+  CHECK_ALLOC(obj->faces);
+  obj->face_normals =
+      heap_tag_calloc(HEAP_TAG_RENDER, count, sizeof(vec3_t), MALLOC_CAP_8BIT);
+  CHECK_ALLOC(obj->face_normals);
+  obj->face_count = 0;
+}
+
+static void face_add(object3d_t *obj, uint16_t a, uint16_t b, uint16_t c) {
+  obj->faces[obj->face_count][0] = a;
+  obj->faces[obj->face_count][1] = b;
+  obj->faces[obj->face_count][2] = c;
+  obj->face_count++;
+}
+
+static void face_add_quad(object3d_t *obj, uint16_t a, uint16_t b,
+                          uint16_t c, uint16_t d) {
+  face_add(obj, a, b, c);
+  face_add(obj, a, c, d);
+}
+
+static vec3_t vertex_get(const object3d_t *obj, uint32_t i) {
+  return (vec3_t){obj->verts.x[i], obj->verts.y[i], obj->verts.z[i]};
+}
+
+// orient: 볼록한 메시로 보고 중심에서 멀어지는 쪽을 바깥으로 삼아 감기 방향을
+// 맞춤, 넓이가 0인 면은 항상 버림
+static void face_finish(object3d_t *obj, bool orient) {
+  vec3_t center = {0, 0, 0};
+  for (uint32_t i = 0; i < obj->verts.count; i++) {
+    vec3_t v = vertex_get(obj, i);
+    center.x += v.x / obj->verts.count;
+    center.y += v.y / obj->verts.count;
+    center.z += v.z / obj->verts.count;
+  }
+
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < obj->face_count; i++) {
+    uint16_t *f = obj->faces[i];
+    vec3_t a = vertex_get(obj, f[0]);
+    vec3_t b = vertex_get(obj, f[1]);
+    vec3_t c = vertex_get(obj, f[2]);
+    vec3_t n = vec3_cross(vec3_sub(b, a), vec3_sub(c, a));
+    if (vec3_dot(n, n) < 1e-8f) continue;
+    vec3_t mid = {(a.x + b.x + c.x) / 3, (a.y + b.y + c.y) / 3,
+                  (a.z + b.z + c.z) / 3};
+    if (orient && vec3_dot(n, vec3_sub(mid, center)) < 0) {
+      uint16_t t = f[1];
+      f[1] = f[2];
+      f[2] = t;
+      n = (vec3_t){-n.x, -n.y, -n.z};
+    }
+    obj->faces[count][0] = f[0];
+    obj->faces[count][1] = f[1];
+    obj->faces[count][2] = f[2];
+    obj->face_normals[count] = vec3_normalize(n);
+    count++;
+  }
+  obj->face_count = count;
+}
+
+/*
+ * edge -> face adjacency for the hidden line mode, built once at load time.
+ * vertices are welded by position first because the sphere repeats its pole
+ * vertex once per longitude.
+ */
+static void edge_faces_build(object3d_t *obj) {
+  uint16_t *weld = heap_tag_calloc(HEAP_TAG_RENDER, obj->verts.count,
+                                   sizeof(uint16_t), MALLOC_CAP_8BIT);
+  CHECK_ALLOC(weld);
+  for (uint32_t i = 0; i < obj->verts.count; i++) {
+    weld[i] = i;
+    vec3_t v = vertex_get(obj, i);
+    for (uint32_t j = 0; j < i; j++) {
+      vec3_t d = vec3_sub(v, vertex_get(obj, j));
+      if (vec3_dot(d, d) < 1e-8f) {
+        weld[i] = weld[j];
+        break;
+      }
+    }
+  }
+
+  obj->edge_faces = heap_tag_calloc(HEAP_TAG_RENDER, obj->edge_count,
+                                    sizeof(uint16_t[2]), MALLOC_CAP_8BIT);
+  CHECK_ALLOC(obj->edge_faces);
+  obj->face_front =
+      heap_tag_calloc(HEAP_TAG_RENDER, obj->face_count, 1, MALLOC_CAP_8BIT);
+  CHECK_ALLOC(obj->face_front);
+  for (uint32_t e = 0; e < obj->edge_count; e++) {
+    uint16_t a = weld[obj->edges[e][0]], b = weld[obj->edges[e][1]];
+    int n = 0;
+    obj->edge_faces[e][0] = obj->edge_faces[e][1] = EDGE_NO_FACE;
+    for (uint32_t f = 0; f < obj->face_count && n < 2; f++) {
+      bool has_a = false, has_b = false;
+      for (int k = 0; k < 3; k++) {
+        has_a |= weld[obj->faces[f][k]] == a;
+        has_b |= weld[obj->faces[f][k]] == b;
       }
+      if (has_a && has_b) obj->edge_faces[e][n++] = f;
+    }
+  }
+  heap_tag_free(HEAP_TAG_RENDER, weld);
+}
+
+// setup_render_data의 객체는 계속 쓰이고 bench.c의 메시만 해제함
+void object3d_free(object3d_t *obj) {
+  heap_tag_free(HEAP_TAG_RENDER, obj->verts.x);
+  heap_tag_free(HEAP_TAG_RENDER, obj->verts.y);
+  heap_tag_free(HEAP_TAG_RENDER, obj->verts.z);
+  heap_tag_free(HEAP_TAG_RENDER, obj->edges);
+  heap_tag_free(HEAP_TAG_RENDER, obj->faces);
+  heap_tag_free(HEAP_TAG_RENDER, obj->face_normals);
+  heap_tag_free(HEAP_TAG_RENDER, obj->edge_faces);
+  heap_tag_free(HEAP_TAG_RENDER, obj->face_front);
+  heap_tag_free(HEAP_TAG_RENDER, obj->screen_xy);
+  heap_tag_free(HEAP_TAG_RENDER, obj->gray_level);
+  memset(obj, 0, sizeof(*obj));
+}
+
+// 자세가 바뀐 객체만 scene 노드를 dirty로 표시
+static void animate_object(render_data_t *data, object3d_t *object,
+                           int64_t t_us) {
+  bool changed = false;
+
+  if (data->transform_mode == TRANSFORM_EULER) {
+    anim_spin_eval(&object->spin, t_us, object->angle);
+    object->rot.orient = rotation_euler(object->angle);
+    changed = true;
+  } else {
+    // 삼각함수 없이 이전 자세에 delta 행렬을 곱해 나감
+    changed = rotation_advance(&object->rot, &object->spin,
+                               atomic_load(&data->sched->period_us), t_us,
+                               &data->ortho_error_max);
+  }
+
+  vec3_t offset = object->offset;
+  if (object->lift) {
+    offset.y += anim_track_eval(object->lift, t_us);
+    changed = true;
+  }
+  if (changed)
+    scene_set_local(&data->scene, object->node, &object->rot.orient, offset,
+                    1.0f);
+}
+
+// 화면상 넓이의 부호로 앞면/뒷면을 나눔, near plane에 걸린 면은 앞면으로 둠
+static void classify_faces(object3d_t *object, const int16_t *xy) {
+  for (uint32_t i = 0; i < object->face_count; i++) {
+    const uint16_t *f = object->faces[i];
+    const int16_t *a = &xy[2 * f[0]], *b = &xy[2 * f[1]], *c = &xy[2 * f[2]];
+    object->face_front[i] = a[0] == XFORM_CLIPPED || b[0] == XFORM_CLIPPED ||
+                            c[0] == XFORM_CLIPPED || fill_area2(a, b, c) > 0;
+  }
+}
+
+// 숨은 선 모드에서는 앞면에 닿은 선분(윤곽선 포함)만 그림
+static bool edge_visible(const object3d_t *object, uint32_t edge) {
+  const uint16_t *f = object->edge_faces[edge];
+  if (f[0] == EDGE_NO_FACE) return true;  // 면에 속하지 않은 선
+  return object->face_front[f[0]] ||
+         (f[1] != EDGE_NO_FACE && object->face_front[f[1]]);
+}
+
+void render_draw_edges(uint8_t *fb, render_data_t *data, object3d_t *object,
+                       const int16_t *xy) {
+  bool hidden_line = data->render_mode == RENDER_HIDDEN_LINE;
+  if (hidden_line) classify_faces(object, xy);
+
+  for (uint32_t i = 0; i < object->edge_count; i++) {
+    uint16_t a = object->edges[i][0];
+    uint16_t b = object->edges[i][1];
+    // near plane 뒤의 정점에 닿는 선분은 건너뜀
+    if (xy[2 * a] == XFORM_CLIPPED || xy[2 * b] == XFORM_CLIPPED) continue;
+    if (hidden_line && !edge_visible(object, i)) continue;
+    raster_line(fb, xy[2 * a], xy[2 * a + 1], xy[2 * b], xy[2 * b + 1]);
+    data->edges_drawn++;
+  }
+  data->edges_total += object->edge_count;
+}
+
+// near plane 앞 정점들의 화면 좌표 외곽 사각형, 화면 밖은 잘라냄
+static frame_rect_t projected_bounds(const object3d_t *object) {
+  const int16_t *xy = object->screen_xy;
+  int x0 = LCD_WIDTH, y0 = LCD_HEIGHT, x1 = -1, y1 = -1;
+  for (uint32_t i = 0; i < object->verts.count; i++) {
+    if (xy[2 * i] == XFORM_CLIPPED) continue;
+    if (xy[2 * i] < x0) x0 = xy[2 * i];
+    if (xy[2 * i] > x1) x1 = xy[2 * i];
+    if (xy[2 * i + 1] < y0) y0 = xy[2 * i + 1];
+    if (xy[2 * i + 1] > y1) y1 = xy[2 * i + 1];
+  }
+  if (x0 < 0) x0 = 0;
+  if (y0 < 0) y0 = 0;
+  if (x1 >= LCD_WIDTH) x1 = LCD_WIDTH - 1;
+  if (y1 >= LCD_HEIGHT) y1 = LCD_HEIGHT - 1;
+  if (x1 < x0 || y1 < y0) return FRAME_RECT_EMPTY;
+  return (frame_rect_t){x0, y0, x1, y1};
+}
+
+// 투영된 선분을 화면에 잘린 외곽 사각형 크기의 타일로 다시 그림
+static void rebuild_tile(render_data_t *data, object3d_t *object) {
+  frame_rect_t r = projected_bounds(object);
+  if (!frame_rect_is_empty(&r))
+    render_draw_edges(data->scratch, data, object, object->screen_xy);
+  raster_tile_capture(&object->tile, data->scratch, r.x1, r.y1,
+                      r.x2 - r.x1 + 1, r.y2 - r.y1 + 1);
+}
+
+// 자세와 카메라가 그대로면 지난 좌표를 재사용, 다시 투영했으면 true
+static bool project_object(render_data_t *data, object3d_t *object) {
+  const scene_node_t *node = &data->scene.nodes[object->node];
+  if (object->proj_valid && object->proj_node_version == node->version &&
+      object->proj_camera_version == data->camera.version) {
+    data->proj_hits++;
+    return false;
+  }
+  // 노드의 world 행렬과 캐시된 view-projection을 객체당 한 번만 합침
+  mat34_t mvp = mat34_mul(&data->camera.view_proj, &node->world);
+  xform_project(&mvp, object->verts.x, object->verts.y, object->verts.z,
+                object->verts.count, CAMERA_NEAR, object->screen_xy);
+  object->proj_node_version = node->version;
+  object->proj_camera_version = data->camera.version;
+  object->proj_valid = true;
+  data->proj_misses++;
+  return true;
+}
+
+// 자세가 바뀐 객체만 다시 투영하고 타일을 새로 그림, 바뀌었으면 true
+static bool draw_live(uint8_t *fb, render_data_t *data, object3d_t *object,
+                      frame_rect_t *rect) {
+  bool changed = project_object(data, object);
+  if (changed) rebuild_tile(data, object);
+  raster_tile_blit(fb, &object->tile);
+  *rect = (frame_rect_t){object->tile.x, object->tile.y,
+                         object->tile.x + object->tile.width - 1,
+                         object->tile.y + object->tile.height - 1};
+  return changed;
+}
+
+// RENDER_FILLED의 coverage 버퍼, 패턴, 광원 방향
+void render_fill_init(render_data_t *data) {
+  data->coverage = heap_tag_calloc(HEAP_TAG_RENDER, LCD_BUF_SIZE,
+                                   sizeof(uint8_t), MALLOC_CAP_8BIT);
+  CHECK_ALLOC(data->coverage);
+  for (int i = 0; i <= FILL_LEVELS; i++) data->patterns[i] = fill_pattern(i);
+  data->light = vec3_normalize(FILL_LIGHT_DIR);
+}
+
+/*
+ * 앞면만 광원 방향에 따른 밝기의 디더 패턴으로 채움. 객체는 가까운 순서로
+ * 그려지고 coverage가 이미 칠해진 픽셀을 막아 주므로 z-buffer가 필요 없음.
+ * 법선은 world의 회전 부분으로 돌림, 그린 삼각형 수를 돌려줌
+ */
+uint32_t render_fill_faces(uint8_t *fb, render_data_t *data,
+                           object3d_t *object, const int16_t *xy,
+                           const mat34_t *world) {
+  fill_target_t target = {fb, data->coverage, LCD_WIDTH, LCD_HEIGHT};
+  uint32_t drawn = 0;
+
+  for (uint32_t i = 0; i < object->face_count; i++) {
+    const uint16_t *f = object->faces[i];
+    const int16_t *a = &xy[2 * f[0]], *b = &xy[2 * f[1]], *c = &xy[2 * f[2]];
+    if (a[0] == XFORM_CLIPPED || b[0] == XFORM_CLIPPED ||
+        c[0] == XFORM_CLIPPED)
+      continue;
+    if (fill_area2(a, b, c) <= 0) continue;  // 뒷면
+
+    const vec3_t *n = &object->face_normals[i];
+    float lambert = (world->m[0][0] * n->x + world->m[0][1] * n->y +
+                     world->m[0][2] * n->z) * data->light.x +
+                    (world->m[1][0] * n->x + world->m[1][1] * n->y +
+                     world->m[1][2] * n->z) * data->light.y +
+                    (world->m[2][0] * n->x + world->m[2][1] * n->y +
+                     world->m[2][2] * n->z) * data->light.z;
+    if (lambert < 0) lambert = 0;
+    int level = FILL_AMBIENT + (int)(lambert * (FILL_LEVELS - FILL_AMBIENT));
+    fill_triangle(&target, a, b, c, &data->patterns[level]);
+    drawn++;
+  }
+  return drawn;
+}
+
+static bool draw_filled(uint8_t *fb, render_data_t *data, object3d_t *object,
+                        frame_rect_t *rect) {
+  bool changed = project_object(data, object);
+  render_fill_faces(fb, data, object, object->screen_xy,
+                    &data->scene.nodes[object->node].world);
+  *rect = projected_bounds(object);
+  return changed;
+}
+
+/*
+ * 선분마다 양 끝 정점의 깊이 단계 평균으로 밝기를 정함. 3은 두 plane 모두,
+ * 2는 plane 0, 1은 plane 1에만 그려 gray_task가 켜져 있는 시간 비율로 표현
+ */
+static bool draw_gray(uint8_t *fb, render_data_t *data, object3d_t *object,
+                      frame_rect_t *rect) {
+  bool changed = project_object(data, object);
+  if (changed) {
+    // view_proj의 z 행은 투영 전 view space 깊이
+    const scene_node_t *node = &data->scene.nodes[object->node];
+    mat34_t mvp = mat34_mul(&data->camera.view_proj, &node->world);
+    for (uint32_t i = 0; i < object->verts.count; i++) {
+      vec3_t v = vertex_get(object, i);
+      object->gray_level[i] = gray_level(mvp.m[2][0] * v.x + mvp.m[2][1] * v.y +
+                                         mvp.m[2][2] * v.z + mvp.m[2][3]);
     }
-    obj->edges[i * SPHERE_LONGITUDE_COUNT][0] =
-        i * SPHERE_LONGITUDE_COUNT + SPHERE_LONGITUDE_COUNT - 1;
-    obj->edges[i * SPHERE_LONGITUDE_COUNT][1] = i * SPHERE_LONGITUDE_COUNT;
-    obj->edges[i * SPHERE_LONGITUDE_COUNT +
-               SPHERE_LATITUDE_COUNT * SPHERE_LONGITUDE_COUNT][0] =
-        i * SPHERE_LONGITUDE_COUNT;
-    obj->edges[i * SPHERE_LONGITUDE_COUNT +
-               SPHERE_LATITUDE_COUNT * SPHERE_LONGITUDE_COUNT][1] =
-        i * SPHERE_LONGITUDE_COUNT + 1;
-
-    obj->edges[(i + 1) * SPHERE_LONGITUDE_COUNT - 1][0] =
-        i * SPHERE_LONGITUDE_COUNT + SPHERE_LONGITUDE_COUNT - 1;
-    obj->edges[(i + 1) * SPHERE_LONGITUDE_COUNT - 1][1] =
-        i * SPHERE_LONGITUDE_COUNT;
-    obj->edges[(i + 1) * SPHERE_LONGITUDE_COUNT - 1 +
-               SPHERE_LATITUDE_COUNT * SPHERE_LONGITUDE_COUNT][0] =
-        i * SPHERE_LONGITUDE_COUNT + SPHERE_LONGITUDE_COUNT - 1;
-    obj->edges[(i + 1) * SPHERE_LONGITUDE_COUNT - 1 +
-               SPHERE_LATITUDE_COUNT * SPHERE_LONGITUDE_COUNT][1] =
-        i * SPHERE_LONGITUDE_COUNT + SPHERE_LONGITUDE_COUNT - 2;
-  }
-  obj->vertex_count = SPHERE_LATITUDE_COUNT * SPHERE_LONGITUDE_COUNT;
-  obj->edge_count = SPHERE_LATITUDE_COUNT * SPHERE_LONGITUDE_COUNT * 2;
-  obj->offset = *offset;
-  obj->rotation = *rotate;
-}
-
-static void draw_object(lv_layer_t *layer, render_data_t *data,
-                        object3d_t *object) {
-  vec3_t *rotated_vertices =
-      heap_caps_malloc(object->vertex_count * sizeof(vec3_t), MALLOC_CAP_8BIT);
-  CHECK_ALLOC(rotated_vertices);
-  lv_memcpy(rotated_vertices, object->vertices,
-            object->vertex_count * sizeof(vec3_t));
-  float *projected_x =
-      heap_caps_malloc(object->vertex_count * sizeof(float), MALLOC_CAP_8BIT);
-  CHECK_ALLOC(projected_x);
-  float *projected_y =
-      heap_caps_malloc(object->vertex_count * sizeof(float), MALLOC_CAP_8BIT);
-  CHECK_ALLOC(projected_y);
-
-  // 회전 및 위치 적용
-  for (int i = 0; i < object->vertex_count; i++) {
-    // 회전 적용
-    rotate_vertex(&rotated_vertices[i], &object->rotation);
-
-    // 위치(offset) 적용
-    rotated_vertices[i].x += object->offset.x;
-    rotated_vertices[i].y += object->offset.y;
-    rotated_vertices[i].z += object->offset.z;
-
-    // 투영
-    project_vertex(rotated_vertices + i, &data->camera_pos, data->fov,
-                   projected_x + i, projected_y + i);
-  }
-
-  lv_draw_line_dsc_t line_dsc;
-  lv_draw_line_dsc_init(&line_dsc);
-  line_dsc.color = lv_color_white();
-  line_dsc.width = 1;
-  // 와이어프레임 그리기
-  for (int i = 0; i < object->edge_count; i++) {
-    line_dsc.p1.x = projected_x[object->edges[i][0]];
-    line_dsc.p1.y = projected_y[object->edges[i][0]];
-    line_dsc.p2.x = projected_x[object->edges[i][1]];
-    line_dsc.p2.y = projected_y[object->edges[i][1]];
-    lv_draw_line(layer, &line_dsc);
-  }
-
-  heap_caps_free(rotated_vertices);
-  heap_caps_free(projected_x);
-  heap_caps_free(projected_y);
-}
-
-static void inline project_vertex(vec3_t *vertex, vec3_t *camera_pos, float fov,
-                                  float *px, float *py) {
-  float rel_x = vertex->x - camera_pos->x;
-  float rel_y = vertex->y - camera_pos->y;
-  float rel_z = vertex->z - camera_pos->z;
-
-  if (rel_z < 0.0f) return;
-  if (rel_z < 0.1f) rel_z = 0.1f;
-
-  // float scale = (1.0f / tanf(fov * 0.5f * (M_PI / 180.0f))) / rel_z;
-  // TODO: 뭔가 이상함 fov가 높을수록 물체가 작아져야 하는데 그 반대임
-  float scale = fov / rel_z;
-
-  *px = (LCD_WIDTH / 2) + (rel_x * scale);
-  *py = (LCD_HEIGHT / 2) - (rel_y * scale);
-}
-
-static void inline rotate_vertex(vec3_t *vertex, vec3_t *rotation) {
-  rotate_x(vertex, rotation->x);
-  rotate_y(vertex, rotation->y);
-  rotate_z(vertex, rotation->z);
-}
-
-// X축 회전
-static void inline rotate_x(vec3_t *vertex, float angle) {
-  float y = vertex->y * cos(angle) - vertex->z * sin(angle);
-  float z = vertex->y * sin(angle) + vertex->z * cos(angle);
-  vertex->y = y;
-  vertex->z = z;
-}
-
-// Y축 회전
-static void inline rotate_y(vec3_t *vertex, float angle) {
-  float x = vertex->x * cos(angle) + vertex->z * sin(angle);
-  float z = -vertex->x * sin(angle) + vertex->z * cos(angle);
-  vertex->x = x;
-  vertex->z = z;
-}
-
-// Z축 회전
-static void inline rotate_z(vec3_t *vertex, float angle) {
-  float x = vertex->x * cos(angle) - vertex->y * sin(angle);
-  float y = vertex->x * sin(angle) + vertex->y * cos(angle);
-  vertex->x = x;
-  vertex->y = y;
-}
\ No newline at end of file
+  }
+  const int16_t *xy = object->screen_xy;
+  bool hidden_line = data->render_mode == RENDER_HIDDEN_LINE;
+  if (hidden_line) classify_faces(object, xy);
+
+  for (uint32_t i = 0; i < object->edge_count; i++) {
+    uint16_t a = object->edges[i][0];
+    uint16_t b = object->edges[i][1];
+    if (xy[2 * a] == XFORM_CLIPPED || xy[2 * b] == XFORM_CLIPPED) continue;
+    if (hidden_line && !edge_visible(object, i)) continue;
+    int level = (object->gray_level[a] + object->gray_level[b] + 1) / 2;
+    if (level >= 2)
+      raster_line(fb, xy[2 * a], xy[2 * a + 1], xy[2 * b], xy[2 * b + 1]);
+    if (level != 2)
+      raster_line(fb + LCD_BUF_SIZE, xy[2 * a], xy[2 * a + 1], xy[2 * b],
+                  xy[2 * b + 1]);
+    data->edges_drawn++;
+  }
+  data->edges_total += object->edge_count;
+  *rect = projected_bounds(object);
+  return changed;
+}
+
+// 카메라에서 가까운 객체부터 그리도록 원점의 깊이로 정렬 (삽입 정렬)
+static void sort_objects(render_data_t *data) {
+  float depth[OBJECT_COUNT];
+  for (int i = 0; i < data->object_count; i++) {
+    const mat34_t *w = &data->scene.nodes[data->objects[i].node].world;
+    vec3_t origin = {w->m[0][3], w->m[1][3], w->m[2][3]};
+    depth[i] = mat34_apply(&data->camera.view_proj, &origin).z;
+  }
+  for (int i = 1; i < data->object_count; i++) {
+    uint8_t idx = data->draw_order[i];
+    int j = i - 1;
+    for (; j >= 0 && depth[data->draw_order[j]] > depth[idx]; j--)
+      data->draw_order[j + 1] = data->draw_order[j];
+    data->draw_order[j + 1] = idx;
+  }
+}
+
+// 양자화된 자세로 scratch 프레임에 그린 뒤 외곽 사각형만 스프라이트로 저장
+static const impostor_t *bake_impostor(render_data_t *data, object3d_t *object,
+                                       uint32_t key, int origin_x,
+                                       int origin_y) {
+  impostor_cache_t *cache = &data->impostors;
+  const scene_node_t *node = &data->scene.nodes[object->node];
+  bam_t angle[3];
+  impostor_quantize(object->angle, angle);
+  mat3_t rot = rotation_euler(angle);
+  mat34_t world = mat34_from_rt(&rot, node->pos);
+  if (node->parent != SCENE_NO_PARENT)
+    world = mat34_mul(&data->scene.nodes[node->parent].world, &world);
+  mat34_t mvp = mat34_mul(&data->camera.view_proj, &world);
+
+  int16_t *xy = object->screen_xy;
+  xform_project(&mvp, object->verts.x, object->verts.y, object->verts.z,
+                object->verts.count, CAMERA_NEAR, xy);
+  object->proj_valid = false;  // 이제 양자화된 자세의 좌표가 들어 있음
+
+  // 화면 안에 온전히 들어오는 실루엣만 스프라이트로 만든다
+  int x0 = LCD_WIDTH, y0 = LCD_HEIGHT, x1 = -1, y1 = -1;
+  for (uint32_t i = 0; i < object->verts.count; i++) {
+    if (xy[2 * i] == XFORM_CLIPPED) return NULL;
+    if (xy[2 * i] < x0) x0 = xy[2 * i];
+    if (xy[2 * i] > x1) x1 = xy[2 * i];
+    if (xy[2 * i + 1] < y0) y0 = xy[2 * i + 1];
+    if (xy[2 * i + 1] > y1) y1 = xy[2 * i + 1];
+  }
+  if (x0 < 0 || y0 < 0 || x1 >= LCD_WIDTH || y1 >= LCD_HEIGHT) return NULL;
+
+  raster_clear(cache->scratch);
+  render_draw_edges(cache->scratch, data, object, xy);
+  return impostor_insert(cache, key, x0, y0, x1 - x0 + 1, y1 - y0 + 1,
+                         x0 - origin_x, y0 - origin_y);
+}
+
+static bool draw_impostor(uint8_t *fb, render_data_t *data,
+                          object3d_t *object, frame_rect_t *rect) {
+  impostor_cache_t *cache = &data->impostors;
+  const scene_node_t *node = &data->scene.nodes[object->node];
+
+  // 카메라가 움직이면 모든 스프라이트의 시점이 달라짐
+  if (cache->camera_version != data->camera.version) {
+    impostor_cache_flush(cache);
+    cache->camera_version = data->camera.version;
+  }
+
+  // 스프라이트는 객체 원점의 투영 위치를 기준으로 붙임
+  vec3_t origin = {node->world.m[0][3], node->world.m[1][3],
+                   node->world.m[2][3]};
+  vec3_t p = mat34_apply(&data->camera.view_proj, &origin);
+  if (p.z < CAMERA_NEAR) return false;
+  float inv_w = fast_recip(p.z);
+  int origin_x = p.x * inv_w;
+  int origin_y = p.y * inv_w;
+
+  uint32_t key = impostor_key(object - data->objects, object->angle);
+  const impostor_t *sprite = impostor_lookup(cache, key);
+  if (!sprite) sprite = bake_impostor(data, object, key, origin_x, origin_y);
+  if (!sprite) return false;
+  impostor_blit(fb, sprite, origin_x, origin_y);
+  int x = origin_x + sprite->origin_x;
+  int y = origin_y + sprite->origin_y;
+  *rect = (frame_rect_t){x, y, x + sprite->width - 1, y + sprite->height - 1};
+  return true;
+}
+
+// 그린 내용이 바뀐 객체는 이전 영역과 새 영역을 모두 dirty로 표시
+static void draw_object(uint8_t *fb, render_data_t *data, object3d_t *object,
+                        frame_rect_t *dirty) {
+  frame_rect_t rect;
+  bool changed;
+  int64_t start = esp_timer_get_time();
+  if (data->render_mode == RENDER_FILLED) {
+    changed = draw_filled(fb, data, object, &rect);
+    data->live_us += esp_timer_get_time() - start;
+    data->live_draws++;
+  } else if (data->gray_mode) {
+    changed = draw_gray(fb, data, object, &rect);
+    data->live_us += esp_timer_get_time() - start;
+    data->live_draws++;
+  } else if (data->impostor_mode && draw_impostor(fb, data, object, &rect)) {
+    // 스프라이트는 매번 새로 붙이므로 위치나 모양이 같아도 보수적으로 갱신
+    changed = true;
+    data->impostor_us += esp_timer_get_time() - start;
+    data->impostor_draws++;
+  } else {
+    changed = draw_live(fb, data, object, &rect);
+    data->live_us += esp_timer_get_time() - start;
+    data->live_draws++;
+  }
+  if (changed) {
+    frame_rect_union(dirty, &object->drawn);
+    frame_rect_union(dirty, &rect);
+  }
+  object->drawn = rect;
+}
+
+/*
+ * sample cloud standing in for sensor data: a jittered torus around the
+ * middle of the scene. a small LCG keeps it identical on every boot.
+ */
+static void points_init(render_data_t *data) {
+  point_cloud_t *pc = &data->points;
+  if (!point_cloud_init(pc, POINT_CLOUD_COUNT, 4.0f)) {
+    ESP_LOGE(TAG, "Failed to allocate memory: %s", "data->points");
+    abort();
+  }
+  pc->budget_us = POINT_CLOUD_BUDGET_US;
+  uint32_t seed = 1;
+  for (uint32_t i = 0; i < pc->count; i++) {
+    seed = seed * 1664525u + 1013904223u;
+    bam_t u = seed;
+    seed = seed * 1664525u + 1013904223u;
+    bam_t v = seed;
+    seed = seed * 1664525u + 1013904223u;
+    float r = 0.8f + (float)(seed >> 24) / 256 * 0.1f;
+    float ring = 2.5f + r * anim_cos(v);
+    point_cloud_set(pc, i,
+                    (vec3_t){ring * anim_cos(u), r * anim_sin(v),
+                             ring * anim_sin(u)});
+  }
+  anim_spin_init(&data->points_spin, 0.6f, 0.4f, 0.0f);
+  data->points_node = scene_add_node(&data->scene, data->scene_root);
+}
+
+static void animate_points(render_data_t *data, int64_t t_us) {
+  bam_t angle[3];
+  anim_spin_eval(&data->points_spin, t_us, angle);
+  mat3_t orient = rotation_euler(angle);
+  scene_set_local(&data->scene, data->points_node, &orient,
+                  (vec3_t){0, 0, 0}, 1.0f);
+}
+
+static void draw_points(uint8_t *fb, render_data_t *data,
+                        frame_rect_t *dirty) {
+  int64_t start = esp_timer_get_time();
+  const scene_node_t *node = &data->scene.nodes[data->points_node];
+  mat34_t mvp = mat34_mul(&data->camera.view_proj, &node->world);
+  point_cloud_draw(&data->points, &mvp, CAMERA_NEAR, fb, LCD_WIDTH,
+                   LCD_HEIGHT);
+  // 점은 화면 전체에 흩어지므로 영역을 따로 계산하지 않음
+  frame_rect_union(dirty,
+                   &(frame_rect_t){0, 0, LCD_WIDTH - 1, LCD_HEIGHT - 1});
+
+  uint32_t elapsed = esp_timer_get_time() - start;
+  point_cloud_adapt(&data->points, elapsed);
+  data->points_us += elapsed;
+}
+
+#if PROF_ENABLED
+// 화면에 실제로 나간 프레임 수(refresh 샘플)로 fps를 계산
+static void post_prof_overlay(render_data_t *data) {
+  static int64_t last_us = 0;
+  int64_t now = esp_timer_get_time();
+  prof_stats_t render, refresh;
+  prof_stats(PROF_RENDER_FRAME, &render);
+  prof_stats(PROF_LVGL_REFRESH, &refresh);
+  if (last_us != 0 && now > last_us) {
+    ui_msg_t msg = {.type = UI_MSG_PROF};
+    msg.prof.fps = (refresh.count * 1000000LL + (now - last_us) / 2) /
+                   (now - last_us);
+    msg.prof.frame_us = render.avg_us + refresh.avg_us;
+    ui_msg_post(data->lcd->ui_queue, &msg);
+  }
+  last_us = now;
+}
+#endif
+
+static void report_impostors(render_data_t *data) {
+  impostor_cache_t *cache = &data->impostors;
+  uint32_t lookups = cache->hits + cache->misses;
+  ESP_LOGI(TAG,
+           "impostor: %" PRIu32 "/%" PRIu32 " hits, %" PRIu32
+           " evicted, %" PRIu32 " bytes, %" PRId64 " us/draw vs %" PRId64
+           " us/draw live",
+           cache->hits, lookups, cache->evictions, cache->bytes,
+           data->impostor_draws ? data->impostor_us / data->impostor_draws : 0,
+           data->live_draws ? data->live_us / data->live_draws : 0);
+  cache->hits = cache->misses = cache->evictions = 0;
+  data->impostor_us = data->live_us = 0;
+  data->impostor_draws = data->live_draws = 0;
+}
+
+#if RENDER_XFORM_BENCH
+// 카메라 앞의 격자 정점을 반복 투영해 초당 정점 수를 측정
+static void xform_bench(render_data_t *data) {
+  vertex_soa_t soa;
+  vertex_soa_alloc(&soa, XFORM_BENCH_VERTICES);
+  for (int i = 0; i < XFORM_BENCH_VERTICES; i++)
+    vertex_soa_set(&soa, i,
+                   (vec3_t){(i % 32) / 16.0f - 1, (i / 32 % 32) / 16.0f - 1,
+                            (i % 7) / 7.0f});
+  int16_t *out = heap_tag_calloc(HEAP_TAG_RENDER, XFORM_BENCH_VERTICES * 2,
+                                 sizeof(int16_t), MALLOC_CAP_8BIT);
+  CHECK_ALLOC(out);
+
+  camera_update(&data->camera);
+  int64_t start = esp_timer_get_time();
+  for (int i = 0; i < XFORM_BENCH_ITERATIONS; i++)
+    xform_project(&data->camera.view_proj, soa.x, soa.y, soa.z, soa.count,
+                  CAMERA_NEAR, out);
+  int64_t elapsed = esp_timer_get_time() - start;
+  ESP_LOGI(TAG,
+           "xform: %d vertices x %d in %" PRId64 " us, %" PRId64
+           " vertices/s",
+           XFORM_BENCH_VERTICES, XFORM_BENCH_ITERATIONS, elapsed,
+           (int64_t)XFORM_BENCH_VERTICES * XFORM_BENCH_ITERATIONS * 1000000 /
+               elapsed);
+
+  heap_tag_free(HEAP_TAG_RENDER, out);
+  heap_tag_free(HEAP_TAG_RENDER, soa.x);
+  heap_tag_free(HEAP_TAG_RENDER, soa.y);
+  heap_tag_free(HEAP_TAG_RENDER, soa.z);
+}
+#endif
@@ -3,40 +3,135 @@
 
 #include <math.h>
 
+#include "anim.h"
+#include "camera.h"
+#include "fill.h"
+#include "frame.h"
+#include "gray.h"
+#include "impostor.h"
 #include "lcd.h"
+#include "math3d.h"
+#include "points.h"
+#include "raster.h"
+#include "rotation.h"
+#include "scene.h"
+#include "xform.h"
 
-typedef struct {
-  float x, y, z;
-} vec3_t;
+#define FOV 75  // horizontal, degrees
+#define EDGE_NO_FACE 0xffff
+#define CONE_SIDES 12
+#define CYLINDER_SIDES 12
+#define SPHERE_LATITUDE_COUNT 6
+#define SPHERE_LONGITUDE_COUNT 12
+#define OBJECT_COUNT 4
+#define SPHERE_LIFT_PERIOD_US 3000000
+
+#define RENDER_MODE RENDER_WIREFRAME
+#define FILL_AMBIENT 3  // shade of faces turned away from the light
+#define FILL_LIGHT_DIR ((vec3_t){-0.4f, 0.6f, -0.7f})
+
+#define RENDER_TRANSFORM_MODE TRANSFORM_INCREMENTAL
+#define RENDER_IMPOSTOR_MODE false  // forces TRANSFORM_EULER
+#define RENDER_POINT_CLOUD false
+#define POINT_CLOUD_COUNT 5000
+#define POINT_CLOUD_BUDGET_US 12000  // decimate above this per frame
+#define RENDER_XFORM_BENCH 0  // log projection throughput at startup
+#define XFORM_BENCH_VERTICES 1024
+#define XFORM_BENCH_ITERATIONS 100
+
+#define RENDER_TASK_STACK_SIZE 4096
+#define RENDER_TASK_PRIORITY 4
+#define RENDER_REPORT_PERIOD_US 1000000
+
+typedef enum {
+  RENDER_WIREFRAME,
+  RENDER_FILLED,       // back-face culled, dithered flat shaded faces
+  RENDER_HIDDEN_LINE,  // only edges touching a front face
+} render_mode_t;
+
+typedef enum {
+  TRANSFORM_EULER,        // orientation rebuilt from the spin angles
+  TRANSFORM_INCREMENTAL,  // orientation advanced by a per-frame delta matrix
+} transform_mode_t;
 
 typedef struct {
-  vec3_t *vertices;
-  uint32_t vertex_count;
-  uint8_t (*edges)[2];
+  vertex_soa_t verts;
+  uint16_t (*edges)[2];
   uint32_t edge_count;
-  vec3_t offset;
-  vec3_t rotation;
+  uint16_t (*faces)[3];  // wound counter clockwise seen from outside
+  vec3_t *face_normals;
+  uint32_t face_count;
+  uint16_t (*edge_faces)[2];  // faces sharing each edge, EDGE_NO_FACE if none
+  uint8_t *face_front;        // per face, from the last projection
+  uint8_t node;     // scene node holding the world transform
+  vec3_t offset;    // position relative to the parent node
+  vec3_t rotation;  // initial euler angles
+  anim_spin_t spin;
+  bam_t angle[3];  // spin angles of the current frame
+  const anim_track_t *lift;  // optional y offset curve
+  rotation_t rot;  // rot.orient is the pose in both transform modes
+  int16_t *screen_xy;            // packed x, y from the last projection
+  uint8_t *gray_level;           // per vertex, from the same projection
+  uint32_t proj_node_version;    // node version screen_xy was built from
+  uint32_t proj_camera_version;  // camera version screen_xy was built from
+  bool proj_valid;
+  raster_tile_t tile;  // edges rasterized at the cached projection
+  frame_rect_t drawn;  // area covered in the previous frame
 } object3d_t;
 
-typedef struct {
+struct render_data_s {
   ssd1306_lcd_panel_t *lcd;
-  vec3_t camera_pos;
-  vec3_t camera_dir;
-  float fov;
+  frame_tribuf_t *frames;
+  frame_sched_t *sched;
+  anim_clock_t clock;
+  transform_mode_t transform_mode;
+  float ortho_error_max;  // worst drift seen before renormalization
+  camera_t camera;
+  scene_t scene;
+  uint8_t scene_root;
   object3d_t *objects;
   uint8_t object_count;
-} render_data_t;
-
-#define FOV 75
-#define CUBE_VERTEX_COUNT 8
-#define CUBE_EDGE_COUNT 12
-#define CONE_SIDES 12
-#define CYLINDER_SIDES 12
-#define SPHERE_LATITUDE_COUNT 6
-#define SPHERE_LONGITUDE_COUNT 12
-#define OBJECT_COUNT 4
+  render_mode_t render_mode;
+  uint8_t draw_order[OBJECT_COUNT];  // front to back in RENDER_FILLED
+  uint8_t *coverage;                 // RENDER_FILLED span buffer
+  fill_pattern_t patterns[FILL_LEVELS + 1];
+  vec3_t light;  // world space, towards the light
+  uint32_t proj_hits;  // objects drawn from cached screen coordinates
+  uint32_t proj_misses;
+  uint32_t edges_drawn;  // edges submitted to the rasterizer
+  uint32_t edges_total;
+  uint8_t *scratch;  // cleared full frame that tiles are rasterized in
+  bool impostor_mode;  // blit cached sprites instead of drawing edges
+  impostor_cache_t impostors;
+  int64_t impostor_us;  // draw time spent on impostor objects
+  int64_t live_us;
+  uint32_t impostor_draws;
+  uint32_t live_draws;
+  bool points_mode;  // draw the sample point cloud on top of the objects
+  point_cloud_t points;
+  uint8_t points_node;
+  anim_spin_t points_spin;
+  int64_t points_us;  // draw time of the point cloud since the last report
+  gray_sched_t *gray;  // NULL unless GRAY_ENABLED
+  bool gray_mode;      // frames carry a second plane for gray_sched_t
+};
 
 render_data_t *setup_render_data(ssd1306_lcd_panel_t *lcd);
-void canvas_render_cb(lv_timer_t *timer);
+void render_frame(render_data_t *data);
+void render_task(void *pvParameters);
+bool render_present(render_data_t *data, lv_obj_t *canvas);
+// the demo meshes and edge loop, bench.c instances them without a scene
+void object3d_cube_init(object3d_t *obj);
+void object3d_cone_init(object3d_t *obj);
+void object3d_cylinder_init(object3d_t *obj);
+void object3d_sphere_init(object3d_t *obj, int lat, int lon);
+void object3d_free(object3d_t *obj);
+void render_draw_edges(uint8_t *fb, render_data_t *data, object3d_t *object,
+                       const int16_t *xy);
+// RENDER_FILLED state and face loop, also used by tools/sim fill_bench
+void render_fill_init(render_data_t *data);
+uint32_t render_fill_faces(uint8_t *fb, render_data_t *data,
+                           object3d_t *object, const int16_t *xy,
+                           const mat34_t *world);
 
 #endif  // __RENDER_C__
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "rotation.h"
+
+#include <math.h>
+#include <string.h>
+
+mat3_t rotation_euler(const bam_t angle[3]) {
+  return mat3_from_euler(anim_sin(angle[0]), anim_cos(angle[0]),
+                         anim_sin(angle[1]), anim_cos(angle[1]),
+                         anim_sin(angle[2]), anim_cos(angle[2]));
+}
+
+void rotation_init(rotation_t *rot, const bam_t angle[3]) {
+  memset(rot, 0, sizeof(*rot));
+  rot->orient = rotation_euler(angle);
+}
+
+// 한 프레임 동안의 회전량, 프레임 주기가 바뀔 때만 다시 계산
+static void build_delta(rotation_t *rot, const anim_spin_t *spin,
+                        uint32_t period_us, int64_t t_us) {
+  // 사인 테이블 보간 오차(~1e-5)는 매 프레임 곱해져 한 시간에 1 rad 가까이
+  // 쌓이므로, 주기가 바뀔 때만 만드는 delta는 libm으로 정확히 계산
+  float s[3], c[3];
+  for (int i = 0; i < 3; i++) {
+    bam_t angle = (bam_t)(spin->rate[i] * period_us / 1000000);
+    float rad = (int32_t)angle * BAM_TO_RAD;
+    s[i] = sinf(rad);
+    c[i] = cosf(rad);
+  }
+  rot->delta = mat3_from_euler(s[0], c[0], s[1], c[1], s[2], c[2]);
+  mat3_orthonormalize(&rot->delta);
+  rot->period_us = period_us;
+  rot->step = rot->anchor_step = t_us / period_us;
+  rot->anchor = rot->orient;
+}
+
+// delta^n을 제곱을 반복해 구함, 곱할 때마다 정규화해 오차가 n에 비례하지 않음
+static mat3_t delta_pow(const mat3_t *delta, int64_t n) {
+  mat3_t r = mat3_identity();
+  mat3_t sq = *delta;
+  while (n > 0) {
+    if (n & 1) {
+      r = mat3_mul(&r, &sq);
+      mat3_orthonormalize(&r);
+    }
+    n >>= 1;
+    if (n == 0) break;
+    sq = mat3_mul(&sq, &sq);
+    mat3_orthonormalize(&sq);
+  }
+  return r;
+}
+
+// 자세가 바뀌었으면 true, ortho_error_max에 정규화 직전 오차의 최댓값을 남김
+bool rotation_advance(rotation_t *rot, const anim_spin_t *spin,
+                      uint32_t period_us, int64_t t_us,
+                      float *ortho_error_max) {
+  if (rot->period_us != period_us) build_delta(rot, spin, period_us, t_us);
+
+  // 건너뛴 프레임만큼 delta를 적용해 움직임이 시간에 묶이도록 함
+  int64_t step = t_us / period_us;
+  int64_t n = step - rot->step;
+  rot->step = step;
+  if (n <= 0) return false;
+  if (n > ROTATION_MAX_STEPS) {
+    // 오래 멈췄으면 하나씩 따라잡지 않고 기준 자세에서 다시 만듦
+    mat3_t d = delta_pow(&rot->delta, step - rot->anchor_step);
+    rot->orient = mat3_mul(&rot->anchor, &d);
+    mat3_orthonormalize(&rot->orient);
+    return true;
+  }
+  for (int64_t i = 0; i < n; i++) {
+    rot->orient = mat3_mul(&rot->orient, &rot->delta);
+    if (++rot->renorm_count % ROTATION_RENORM_INTERVAL == 0) {
+      float err = mat3_ortho_error(&rot->orient);
+      if (err > *ortho_error_max) *ortho_error_max = err;
+      mat3_orthonormalize(&rot->orient);
+    }
+  }
+  return true;
+}
@@ -0,0 +1,40 @@
+#ifndef __ROTATION_H__
+#define __ROTATION_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "anim.h"
+#include "math3d.h"
+
+/*
+ * incremental rotation for a spinning object: the orientation advances by
+ * a per-frame delta matrix instead of rebuilding it with trig every frame.
+ * rounding is removed by a Gram-Schmidt pass every ROTATION_RENORM_INTERVAL
+ * steps. the pose at a time is anchor * delta^(step - anchor_step), so a
+ * backlog over ROTATION_MAX_STEPS (a stall) is caught up with a handful of
+ * squarings instead of one multiply per missed frame, and the motion stays
+ * locked to the clock. portable, tools/rotation_test runs it for an hour.
+ */
+
+#define ROTATION_RENORM_INTERVAL 64
+#define ROTATION_MAX_STEPS 64  // above this the pose is rebuilt from anchor
+#define ROTATION_ORTHO_ERROR_LIMIT 1e-5f  // asserted by tools/rotation_test
+
+typedef struct {
+  mat3_t orient;
+  mat3_t delta;   // rotation over one frame period
+  mat3_t anchor;  // orient when delta was built
+  uint32_t period_us;
+  int64_t anchor_step;
+  int64_t step;  // frame periods already applied to orient
+  uint32_t renorm_count;
+} rotation_t;
+
+mat3_t rotation_euler(const bam_t angle[3]);
+void rotation_init(rotation_t *rot, const bam_t angle[3]);
+bool rotation_advance(rotation_t *rot, const anim_spin_t *spin,
+                      uint32_t period_us, int64_t t_us,
+                      float *ortho_error_max);
+
+#endif  // __ROTATION_H__
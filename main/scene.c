@@ -0,0 +1,59 @@
+#include "scene.h"
+
+#include <stdlib.h>
+
+#include "esp_log.h"
+
+#define TAG "SCENE"
+
+void scene_init(scene_t *scene) { scene->count = 0; }
+
+uint8_t scene_add_node(scene_t *scene, uint8_t parent) {
+  if (scene->count >= SCENE_MAX_NODES ||
+      (parent != SCENE_NO_PARENT && parent >= scene->count)) {
+    ESP_LOGE(TAG, "Invalid scene node (parent %d, count %d)", parent,
+             scene->count);
+    abort();
+  }
+  uint8_t idx = scene->count++;
+  scene_node_t *node = &scene->nodes[idx];
+  node->parent = parent;
+  node->scale = 1.0f;
+  node->rot = mat3_identity();
+  node->pos = (vec3_t){0, 0, 0};
+  node->dirty = true;
+  node->changed = false;
+  node->version = 0;
+  return idx;
+}
+
+void scene_set_local(scene_t *scene, uint8_t node, const mat3_t *rot,
+                     vec3_t pos, float scale) {
+  scene_node_t *n = &scene->nodes[node];
+  n->rot = *rot;
+  n->pos = pos;
+  n->scale = scale;
+  n->dirty = true;
+}
+
+void scene_update(scene_t *scene) {
+  for (int i = 0; i < scene->count; i++) {
+    scene_node_t *n = &scene->nodes[i];
+    // 부모가 먼저 갱신되므로 부모의 changed만 보면 하위 트리 전체가 전파됨
+    n->changed = n->dirty || (n->parent != SCENE_NO_PARENT &&
+                              scene->nodes[n->parent].changed);
+    if (!n->changed) continue;
+
+    mat34_t local = mat34_from_rt(&n->rot, n->pos);
+    if (n->scale != 1.0f)
+      for (int r = 0; r < 3; r++)
+        for (int c = 0; c < 3; c++) local.m[r][c] *= n->scale;
+
+    if (n->parent == SCENE_NO_PARENT)
+      n->world = local;
+    else
+      n->world = mat34_mul(&scene->nodes[n->parent].world, &local);
+    n->dirty = false;
+    n->version++;
+  }
+}
@@ -0,0 +1,39 @@
+#ifndef __SCENE_H__
+#define __SCENE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "math3d.h"
+
+#define SCENE_MAX_NODES 16
+#define SCENE_NO_PARENT 0xff
+
+typedef struct {
+  uint8_t parent;  // always a lower index than the node itself
+  bool dirty;      // local transform changed since the last update
+  bool changed;    // world transform was recomputed in the last update
+  float scale;
+  mat3_t rot;
+  vec3_t pos;
+  mat34_t world;
+  uint32_t version;  // bumped whenever world changes
+} scene_node_t;
+
+/*
+ * nodes are stored contiguously in topological order (parents first), so
+ * world transforms are refreshed in a single linear pass and only the dirty
+ * subtrees are recomputed.
+ */
+typedef struct {
+  scene_node_t nodes[SCENE_MAX_NODES];
+  uint8_t count;
+} scene_t;
+
+void scene_init(scene_t *scene);
+uint8_t scene_add_node(scene_t *scene, uint8_t parent);
+void scene_set_local(scene_t *scene, uint8_t node, const mat3_t *rot,
+                     vec3_t pos, float scale);
+void scene_update(scene_t *scene);
+
+#endif  // __SCENE_H__
@@ -0,0 +1,142 @@
+#include "stream.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "heap_tag.h"
+#include "sdkconfig.h"
+
+#define TAG "STREAM"
+
+#if STREAM_ENABLED
+
+#include "driver/uart.h"
+#include "driver/uart_vfs.h"
+
+#if !CONFIG_ESP_CONSOLE_UART
+#error "frame streaming needs the console on a UART"
+#endif
+
+#define STREAM_UART CONFIG_ESP_CONSOLE_UART_NUM
+#define STREAM_RX_BUFFER 256  // the driver wants more than the 128 byte FIFO
+
+#define CHECK_ALLOC(ptr)                                    \
+  do {                                                      \
+    if (ptr == NULL) {                                      \
+      ESP_LOGE(TAG, "Failed to allocate memory: %s", #ptr); \
+      abort();                                              \
+    }                                                       \
+  } while (0)
+
+static uint32_t base64(const uint8_t *src, uint32_t len, char *out) {
+  static const char digits[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  char *o = out;
+  for (uint32_t i = 0; i < len; i += 3) {
+    uint32_t v = src[i] << 16;
+    if (i + 1 < len) v |= src[i + 1] << 8;
+    if (i + 2 < len) v |= src[i + 2];
+    *o++ = digits[v >> 18];
+    *o++ = digits[v >> 12 & 63];
+    *o++ = i + 1 < len ? digits[v >> 6 & 63] : '=';
+    *o++ = i + 2 < len ? digits[v & 63] : '=';
+  }
+  return o - out;
+}
+
+// 복원된 프레임 확인용, 뷰어가 같은 값을 계산함
+static uint32_t fnv1a32(const uint8_t *p, uint32_t n) {
+  uint32_t h = 2166136261u;
+  while (n--) h = (h ^ *p++) * 16777619u;
+  return h;
+}
+
+static void send_frame(frame_stream_t *s) {
+  bool key = s->seq == 0 || s->since_key >= STREAM_KEY_INTERVAL;
+  bool changed = key;
+  for (int i = 0; i < LCD_BUF_SIZE; i++) {
+    s->delta[i] = key ? s->pending[i] : s->pending[i] ^ s->sent[i];
+    changed |= s->delta[i] != 0;
+  }
+  if (!changed) return;
+
+  uint32_t packed = packbits_pack(s->delta, LCD_BUF_SIZE, s->packed);
+  size_t len = snprintf(s->line, sizeof(s->line),
+                        "stream,%u,%c,%08" PRIx32 ",", s->seq, key ? 'k' : 'd',
+                        fnv1a32(s->pending, LCD_BUF_SIZE));
+  len += base64(s->packed, packed, s->line + len);
+  s->line[len++] = '\n';
+
+  // 링에 자리가 없으면 기다리지 않고 버림, 다음 delta는 여전히 sent 기준
+  size_t free_bytes = 0;
+  uart_get_tx_buffer_free_size(STREAM_UART, &free_bytes);
+  if (free_bytes < len + STREAM_TX_HEADROOM) {
+    s->dropped_tx++;
+    return;
+  }
+  uart_write_bytes(STREAM_UART, s->line, len);
+  memcpy(s->sent, s->pending, LCD_BUF_SIZE);
+  s->seq++;
+  s->since_key = key ? 0 : s->since_key + 1;
+  s->sent_frames++;
+  s->sent_bytes += len;
+}
+
+static void stream_task(void *pvParameters) {
+  frame_stream_t *s = pvParameters;
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    send_frame(s);
+    atomic_store_explicit(&s->busy, false, memory_order_release);
+  }
+}
+
+frame_stream_t *stream_create(void) {
+  frame_stream_t *s = heap_tag_calloc(HEAP_TAG_LCD, 1, sizeof(frame_stream_t),
+                                      MALLOC_CAP_8BIT);
+  CHECK_ALLOC(s);
+  // 콘솔 출력도 드라이버를 거치게 해 스트림 줄과 로그 줄이 섞이지 않게 함
+  if (!uart_is_driver_installed(STREAM_UART)) {
+    ESP_ERROR_CHECK(uart_driver_install(STREAM_UART, STREAM_RX_BUFFER,
+                                        STREAM_TX_BUFFER, 0, NULL, 0));
+    uart_vfs_dev_use_driver(STREAM_UART);
+  }
+  xTaskCreate(stream_task, "stream_task", STREAM_TASK_STACK_SIZE, s,
+              STREAM_TASK_PRIORITY, &s->task);
+  trace_register_task(s->task);
+  return s;
+}
+
+// lvgl_flush_cb에서 한 갱신의 마지막 flush 뒤에 불림, 복사 한 번이 전부
+void stream_submit(frame_stream_t *s, const uint8_t *pages) {
+  atomic_fetch_add(&s->submitted, 1);
+  if (atomic_load_explicit(&s->busy, memory_order_acquire)) {
+    atomic_fetch_add(&s->dropped_busy, 1);
+    return;
+  }
+  memcpy(s->pending, pages, LCD_BUF_SIZE);
+  atomic_store_explicit(&s->busy, true, memory_order_relaxed);
+  xTaskNotifyGive(s->task);
+}
+
+void stream_report(frame_stream_t *s, uint32_t period_ms) {
+  uint32_t submitted = atomic_exchange(&s->submitted, 0);
+  uint32_t dropped_busy = atomic_exchange(&s->dropped_busy, 0);
+  ESP_LOGI(TAG,
+           "%" PRIu32 "/%" PRIu32 " frames sent, %" PRIu32
+           " B/s, dropped %" PRIu32 " busy %" PRIu32 " tx full",
+           s->sent_frames, submitted, s->sent_bytes * 1000 / period_ms,
+           dropped_busy, s->dropped_tx);
+  s->sent_frames = s->sent_bytes = s->dropped_tx = 0;
+}
+
+#else
+
+frame_stream_t *stream_create(void) { return NULL; }
+void stream_submit(frame_stream_t *s, const uint8_t *pages) {}
+void stream_report(frame_stream_t *s, uint32_t period_ms) {}
+
+#endif  // STREAM_ENABLED
@@ -0,0 +1,60 @@
+#ifndef __STREAM_H__
+#define __STREAM_H__
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lcd.h"
+#include "packbits.h"
+
+/*
+ * mirrors what lvgl_flush_cb sends to the panel over the console UART.
+ * the flush only copies the page buffer into a free slot (a busy slot drops
+ * the frame); a low priority task XORs it against the last frame sent,
+ * packbits-compresses the delta and writes one base64 'stream,' line into
+ * the UART driver's TX ring, which the ISR drains while rendering goes on.
+ * a line that does not fit in the free ring space is dropped, never waited
+ * for. tools/stream_view.py rebuilds the frames from a port or a log.
+ *
+ * at the default 115200 baud a few frames per second get through, raise
+ * CONFIG_ESP_CONSOLE_UART_BAUDRATE for more.
+ */
+
+#ifndef STREAM_ENABLED
+#define STREAM_ENABLED 0  // tools/sim always builds with it on
+#endif
+#define STREAM_KEY_INTERVAL 30  // deltas between full frames
+#define STREAM_TX_BUFFER 4096   // UART driver ring
+#define STREAM_TX_HEADROOM 512  // ring space left for log lines
+#define STREAM_TASK_STACK_SIZE 3072
+#define STREAM_TASK_PRIORITY 1
+
+#define STREAM_PACKED_MAX PACKBITS_MAX_SIZE(LCD_BUF_SIZE)
+#define STREAM_LINE_MAX (32 + (STREAM_PACKED_MAX + 2) / 3 * 4)
+
+struct frame_stream_s {
+  uint8_t pending[LCD_BUF_SIZE];  // owned by the stream task while busy
+  uint8_t sent[LCD_BUF_SIZE];     // what the viewer has
+  uint8_t delta[LCD_BUF_SIZE];
+  uint8_t packed[STREAM_PACKED_MAX];
+  char line[STREAM_LINE_MAX];
+  _Atomic bool busy;
+  TaskHandle_t task;
+  uint16_t seq;
+  uint16_t since_key;
+  // since the last report
+  _Atomic uint32_t submitted;
+  _Atomic uint32_t dropped_busy;  // flushes while the task was still busy
+  uint32_t dropped_tx;            // lines that did not fit in the TX ring
+  uint32_t sent_frames;
+  uint32_t sent_bytes;
+};
+
+frame_stream_t *stream_create(void);
+void stream_submit(frame_stream_t *s, const uint8_t *pages);
+void stream_report(frame_stream_t *s, uint32_t period_ms);
+
+#endif  // __STREAM_H__
@@ -0,0 +1,114 @@
+#include "sysmon.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#define TAG "SYSMON"
+
+void sysmon_init(sysmon_t *mon) {
+  memset(mon, 0, sizeof(*mon));
+  mon->period_ms = SYSMON_PERIOD_MS;
+}
+
+static sysmon_task_t *find_task(sysmon_t *mon, const TaskStatus_t *st) {
+  for (uint32_t i = 0; i < mon->task_count; i++)
+    if (mon->tasks[i].handle == st->xHandle) return &mon->tasks[i];
+
+  // 지워진 태스크의 자리를 재사용, 없으면 새 자리
+  sysmon_task_t *t = NULL;
+  for (uint32_t i = 0; i < mon->task_count && !t; i++)
+    if (!mon->tasks[i].alive) t = &mon->tasks[i];
+  if (!t) {
+    if (mon->task_count >= SYSMON_MAX_TASKS) return NULL;
+    t = &mon->tasks[mon->task_count++];
+  }
+  memset(t, 0, sizeof(*t));
+  t->handle = st->xHandle;
+  snprintf(t->name, sizeof(t->name), "%s", st->pcTaskName);
+  t->last_runtime = st->ulRunTimeCounter;
+  t->stack_min_free = UINT32_MAX;
+  return t;
+}
+
+static void sysmon_sample(sysmon_t *mon) {
+  int64_t start = esp_timer_get_time();
+  uint32_t total;
+  UBaseType_t n =
+      uxTaskGetSystemState(mon->status, SYSMON_MAX_TASKS, &total);
+  if (n == 0) {
+    ESP_LOGW(TAG, "More than %d tasks, not sampled", SYSMON_MAX_TASKS);
+    return;
+  }
+  uint32_t total_delta = total - mon->last_total_runtime;
+  mon->last_total_runtime = total;
+  uint32_t slot = mon->samples % SYSMON_HISTORY;
+
+  for (uint32_t i = 0; i < mon->task_count; i++) mon->tasks[i].alive = false;
+  for (UBaseType_t i = 0; i < n; i++) {
+    const TaskStatus_t *st = &mon->status[i];
+    sysmon_task_t *t = find_task(mon, st);
+    if (!t) continue;
+    uint32_t delta = st->ulRunTimeCounter - t->last_runtime;
+    t->last_runtime = st->ulRunTimeCounter;
+    t->alive = true;
+    t->priority = st->uxCurrentPriority;
+    // IDF에서 high-water mark는 word가 아니라 바이트 단위
+    uint32_t free = st->usStackHighWaterMark;
+    if (free < t->stack_min_free) t->stack_min_free = free;
+    t->cpu_pct[slot] =
+        total_delta ? (uint64_t)delta * 100 / total_delta : 0;
+    t->stack_free[slot] = free > UINT16_MAX ? UINT16_MAX : free;
+  }
+  mon->samples++;
+
+  mon->cost_us = esp_timer_get_time() - start;
+  if (mon->cost_us > mon->cost_max_us) mon->cost_max_us = mon->cost_us;
+  if (mon->cost_us > SYSMON_COST_MAX_US &&
+      mon->period_ms < SYSMON_PERIOD_MAX_MS) {
+    mon->period_ms *= 2;
+    ESP_LOGW(TAG, "Sample took %" PRIu32 "us, period now %" PRIu32 "ms",
+             mon->cost_us, mon->period_ms);
+  }
+}
+
+// 주기가 되면 샘플링하고 true
+bool sysmon_poll(sysmon_t *mon, uint32_t elapsed_ms) {
+  if (elapsed_ms < mon->due_ms) {
+    mon->due_ms -= elapsed_ms;
+    return false;
+  }
+  sysmon_sample(mon);
+  mon->due_ms = mon->period_ms;
+  return true;
+}
+
+// age 0이 가장 최근 샘플, 아직 없는 샘플은 0
+uint8_t sysmon_history(const sysmon_task_t *task, uint32_t samples,
+                       uint32_t age) {
+  if (age >= samples || age >= SYSMON_HISTORY) return 0;
+  return task->cpu_pct[(samples - 1 - age) % SYSMON_HISTORY];
+}
+
+void sysmon_report(sysmon_t *mon) {
+  if (mon->samples == 0) return;
+  uint32_t slot = (mon->samples - 1) % SYSMON_HISTORY;
+  ESP_LOGI(TAG, "sample cost %" PRIu32 "us (max %" PRIu32 "us), every %" PRIu32
+           "ms", mon->cost_us, mon->cost_max_us, mon->period_ms);
+  for (uint32_t i = 0; i < mon->task_count; i++) {
+    const sysmon_task_t *t = &mon->tasks[i];
+    if (!t->alive) continue;
+    // 최소 여유 공간에서 여유분을 뺀 만큼 스택을 줄일 수 있음
+    uint32_t spare = t->stack_min_free > SYSMON_STACK_MARGIN
+                         ? t->stack_min_free - SYSMON_STACK_MARGIN
+                         : 0;
+    ESP_LOGI(TAG,
+             "  %-16s prio %2u cpu %3u%% stack min free %5" PRIu32
+             " (could shrink by %" PRIu32 ")",
+             t->name, (unsigned)t->priority, t->cpu_pct[slot],
+             t->stack_min_free, spare);
+  }
+}
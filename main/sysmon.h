@@ -0,0 +1,56 @@
+#ifndef __SYSMON_H__
+#define __SYSMON_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/*
+ * per-task CPU share and stack high-water mark history. stats_task samples
+ * uxTaskGetSystemState (needs FREERTOS_USE_TRACE_FACILITY and
+ * FREERTOS_GENERATE_RUN_TIME_STATS) into fixed rings; the monitor screen in
+ * lcd.c draws them as sparklines. a sample walks every task with the
+ * scheduler suspended, so its cost is measured and the period backs off
+ * when it gets too expensive.
+ */
+
+#define SYSMON_MAX_TASKS 12
+#define SYSMON_HISTORY 40  // samples, one sparkline pixel each
+#define SYSMON_PERIOD_MS 1000
+#define SYSMON_PERIOD_MAX_MS 8000
+#define SYSMON_COST_MAX_US 500   // a slower sample doubles the period
+#define SYSMON_STACK_MARGIN 512  // headroom kept when suggesting stack sizes
+#define SYSMON_SCREEN_CYCLE_MS 0  // > 0: alternate with the render screen
+
+typedef struct {
+  TaskHandle_t handle;
+  char name[configMAX_TASK_NAME_LEN];
+  UBaseType_t priority;
+  bool alive;  // present in the last sample
+  uint32_t last_runtime;
+  uint32_t stack_min_free;  // bytes, lowest high-water mark seen
+  uint8_t cpu_pct[SYSMON_HISTORY];
+  uint16_t stack_free[SYSMON_HISTORY];
+} sysmon_task_t;
+
+typedef struct {
+  TaskStatus_t status[SYSMON_MAX_TASKS];
+  sysmon_task_t tasks[SYSMON_MAX_TASKS];
+  uint32_t task_count;
+  uint32_t samples;  // total, the rings hold the last SYSMON_HISTORY
+  uint32_t last_total_runtime;
+  uint32_t period_ms;
+  uint32_t due_ms;  // time left until the next sample
+  uint32_t cost_us;  // duration of the last sample
+  uint32_t cost_max_us;
+} sysmon_t;
+
+void sysmon_init(sysmon_t *mon);
+bool sysmon_poll(sysmon_t *mon, uint32_t elapsed_ms);
+void sysmon_report(sysmon_t *mon);
+uint8_t sysmon_history(const sysmon_task_t *task, uint32_t samples,
+                       uint32_t age);
+
+#endif  // __SYSMON_H__
@@ -0,0 +1,199 @@
+#include "trace.h"
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "trace_hooks.h"
+
+#define TAG "TRACE"
+#define CYCLES_PER_US CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ
+#define TRACE_MAX_LOCKS 4
+
+#if TRACE_ENABLED
+
+typedef struct {
+  uint32_t cycles;
+  uint32_t arg;  // pointer | trace_type_t
+} trace_event_t;
+
+typedef struct {
+  TaskHandle_t handle;
+  char name[configMAX_TASK_NAME_LEN];
+} trace_task_t;
+
+static trace_event_t events[TRACE_EVENTS];
+static uint32_t next_event;
+static volatile bool paused = false;
+static volatile bool dump_requested = false;
+static int64_t last_dump_us = 0;
+static trace_task_t tasks[TRACE_MAX_TASKS];
+static uint32_t task_count = 0;
+static traced_mutex_t *locks[TRACE_MAX_LOCKS];
+static uint32_t lock_count = 0;
+
+// 스케줄러 안(인터럽트 금지 상태)에서도 불리므로 IRAM에 두고 락 없이 씀,
+// 단일 코어라 인터럽트만 막으면 슬롯 예약이 원자적임
+static IRAM_ATTR void trace_put(trace_type_t type, const void *arg) {
+  if (paused) return;
+  UBaseType_t state = portSET_INTERRUPT_MASK_FROM_ISR();
+  trace_event_t *e = &events[next_event++ & (TRACE_EVENTS - 1)];
+  e->cycles = esp_cpu_get_cycle_count();
+  e->arg = (uint32_t)(uintptr_t)arg | type;
+  portCLEAR_INTERRUPT_MASK_FROM_ISR(state);
+}
+
+IRAM_ATTR void trace_task_switched_in(void) {
+  trace_put(TRACE_SWITCH_IN, xTaskGetCurrentTaskHandle());
+}
+
+void trace_register_task(TaskHandle_t task) {
+  if (!task || task_count >= TRACE_MAX_TASKS) return;
+  // 태스크가 나중에 지워져도 이름을 쓸 수 있도록 복사해 둠
+  tasks[task_count].handle = task;
+  snprintf(tasks[task_count].name, sizeof(tasks[task_count].name), "%s",
+           pcTaskGetName(task));
+  task_count++;
+}
+
+void trace_init(void) {
+  static const char *const system_tasks[] = {"IDLE", "esp_timer", "Tmr Svc"};
+  trace_register_task(xTaskGetCurrentTaskHandle());
+  for (int i = 0; i < sizeof(system_tasks) / sizeof(system_tasks[0]); i++)
+    trace_register_task(xTaskGetHandle(system_tasks[i]));
+}
+
+static void trace_dump(void) {
+  paused = true;
+  uint32_t end = next_event;
+  uint32_t start = end > TRACE_EVENTS ? end - TRACE_EVENTS : 0;
+  printf("trace,begin,%" PRIu32 "\n", end - start);
+  for (uint32_t i = 0; i < task_count; i++)
+    printf("trace,task,%08" PRIx32 ",%s\n", (uint32_t)(uintptr_t)tasks[i].handle,
+           tasks[i].name);
+  for (uint32_t i = 0; i < lock_count; i++)
+    printf("trace,lock,%08" PRIx32 ",%s\n", (uint32_t)(uintptr_t)locks[i],
+           locks[i]->name);
+  for (uint32_t i = start; i < end; i++) {
+    const trace_event_t *e = &events[i & (TRACE_EVENTS - 1)];
+    printf("trace,ev,%" PRIu32 ",%" PRIu32 ",%08" PRIx32 "\n", e->cycles,
+           e->arg & 3, e->arg & ~3u);
+  }
+  printf("trace,end,%d\n", CYCLES_PER_US);
+  next_event = 0;
+  paused = false;
+}
+
+static void trace_request_dump(void) { dump_requested = true; }
+
+// 부팅 후 한 번, 그 뒤로는 긴 락 대기가 있을 때만 덤프
+void trace_poll(void) {
+  int64_t now = esp_timer_get_time();
+  if (now - last_dump_us < TRACE_DUMP_AFTER_MS * 1000LL) return;
+  if (last_dump_us != 0 && !dump_requested) return;
+  trace_dump();
+  dump_requested = false;
+  last_dump_us = now;
+}
+
+#else
+
+#define trace_put(type, arg) (void)0
+#define trace_request_dump() (void)0
+
+void trace_init(void) {}
+void trace_register_task(TaskHandle_t task) {}
+void trace_poll(void) {}
+
+#endif  // TRACE_ENABLED
+
+void traced_mutex_init(traced_mutex_t *m, const char *name) {
+  memset(m, 0, sizeof(*m));
+  m->handle = xSemaphoreCreateMutex();
+  if (m->handle == NULL) {
+    ESP_LOGE(TAG, "Failed to allocate memory: %s", name);
+    abort();
+  }
+  m->name = name;
+#if TRACE_ENABLED
+  if (lock_count < TRACE_MAX_LOCKS) locks[lock_count++] = m;
+#endif
+}
+
+bool traced_mutex_take(traced_mutex_t *m, TickType_t timeout) {
+  bool contended = false;
+  uint32_t start = esp_cpu_get_cycle_count();
+  if (xSemaphoreTake(m->handle, 0) != pdTRUE) {
+    contended = true;
+    trace_put(TRACE_LOCK_WAIT, m);
+    if (xSemaphoreTake(m->handle, timeout) != pdTRUE) {
+      trace_put(TRACE_LOCK_GIVE, m);
+      atomic_fetch_add(&m->timeouts, 1);
+      return false;
+    }
+  }
+  uint32_t now = esp_cpu_get_cycle_count();
+  trace_put(TRACE_LOCK_TAKE, m);
+
+  // 여기부터는 락을 쥐고 있으므로 통계를 그대로 갱신해도 됨
+  m->owner = xTaskGetCurrentTaskHandle();
+  m->taken_cycles = now;
+  m->takes++;
+  if (contended) {
+    uint32_t wait_us = (now - start) / CYCLES_PER_US;
+    m->contended++;
+    m->wait_total_us += wait_us;
+    if (wait_us > m->wait_max_us) {
+      m->wait_max_us = wait_us;
+      m->wait_max_task = m->owner;
+    }
+    if (wait_us > TRACE_DUMP_WAIT_US) trace_request_dump();
+  }
+  return true;
+}
+
+void traced_mutex_give(traced_mutex_t *m) {
+  uint32_t hold_us = (esp_cpu_get_cycle_count() - m->taken_cycles) /
+                     CYCLES_PER_US;
+  m->hold_total_us += hold_us;
+  if (hold_us > m->hold_max_us) {
+    m->hold_max_us = hold_us;
+    m->hold_max_task = m->owner;
+  }
+  m->owner = NULL;
+  trace_put(TRACE_LOCK_GIVE, m);
+  xSemaphoreGive(m->handle);
+}
+
+static const char *task_name(TaskHandle_t task) {
+  return task ? pcTaskGetName(task) : "-";
+}
+
+void traced_mutex_report(traced_mutex_t *m) {
+  // 통계를 복사하고 지우는 동안만 잠금, 이 대기는 통계에 넣지 않음
+  xSemaphoreTake(m->handle, portMAX_DELAY);
+  traced_mutex_t s = *m;
+  m->takes = m->contended = 0;
+  m->wait_max_us = m->hold_max_us = 0;
+  m->wait_total_us = m->hold_total_us = 0;
+  m->wait_max_task = m->hold_max_task = NULL;
+  xSemaphoreGive(m->handle);
+  uint32_t timeouts = atomic_exchange(&m->timeouts, 0);
+  if (s.takes == 0 && timeouts == 0) return;
+
+  ESP_LOGI(TAG,
+           "%s: %" PRIu32 " takes, %" PRIu32 " contended (wait avg %" PRIu64
+           "us, max %" PRIu32 "us by %s), hold avg %" PRIu64 "us, max %" PRIu32
+           "us by %s, %" PRIu32 " timeouts",
+           s.name, s.takes, s.contended,
+           s.contended ? s.wait_total_us / s.contended : 0, s.wait_max_us,
+           task_name(s.wait_max_task),
+           s.takes ? s.hold_total_us / s.takes : 0, s.hold_max_us,
+           task_name(s.hold_max_task), timeouts);
+}
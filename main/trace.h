@@ -0,0 +1,67 @@
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+/*
+ * scheduler and lock tracing. context switches (traceTASK_SWITCHED_IN) and
+ * traced_mutex waits/holds go into a RAM ring of 8 byte events stamped
+ * with the CPU cycle counter. the ring is dumped over the console as
+ * 'trace,' lines, tools/trace2json.py turns a captured log into a
+ * Chrome/Perfetto trace.
+ *
+ * traced_mutex_t keeps wait/hold statistics even with TRACE_ENABLED 0,
+ * only the event ring and the switch hook compile out. idf.py -DTRACE=ON
+ * turns it on and force-includes trace_hooks.h, without it FreeRTOS keeps
+ * its empty default hook.
+ */
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 0
+#endif
+#define TRACE_EVENTS 1024          // ring size, must be a power of two
+#define TRACE_MAX_TASKS 12         // named tasks in the dump
+#define TRACE_DUMP_AFTER_MS 10000  // first dump, then minimum gap between dumps
+#define TRACE_DUMP_WAIT_US 5000    // a longer lock wait requests a dump
+
+// event type lives in the low bits of the (4 byte aligned) argument
+typedef enum {
+  TRACE_SWITCH_IN = 0,  // arg: task handle
+  TRACE_LOCK_WAIT = 1,  // arg: traced_mutex_t, by the running task
+  TRACE_LOCK_TAKE = 2,
+  TRACE_LOCK_GIVE = 3,  // also ends a wait that timed out
+} trace_type_t;
+
+typedef struct {
+  SemaphoreHandle_t handle;
+  const char *name;
+  TaskHandle_t owner;
+  uint32_t taken_cycles;  // cycle counter when the owner got it
+  // since the last report
+  uint32_t takes;
+  uint32_t contended;         // takes that had to wait
+  _Atomic uint32_t timeouts;  // updated without holding the lock
+  uint32_t wait_max_us;
+  uint32_t hold_max_us;
+  uint64_t wait_total_us;
+  uint64_t hold_total_us;
+  TaskHandle_t wait_max_task;  // who waited longest
+  TaskHandle_t hold_max_task;  // who held longest
+} traced_mutex_t;
+
+void trace_init(void);
+void trace_register_task(TaskHandle_t task);
+void trace_poll(void);
+
+void traced_mutex_init(traced_mutex_t *m, const char *name);
+bool traced_mutex_take(traced_mutex_t *m, TickType_t timeout);
+void traced_mutex_give(traced_mutex_t *m);
+void traced_mutex_report(traced_mutex_t *m);
+
+#endif  // __TRACE_H__
@@ -0,0 +1,15 @@
+#ifndef __TRACE_HOOKS_H__
+#define __TRACE_HOOKS_H__
+
+/*
+ * force-included into every C file of a -DTRACE=ON build (see the top level
+ * CMakeLists.txt) so FreeRTOS' tasks.c picks up the hook. keep this free of
+ * includes, it is seen before anything else.
+ */
+void trace_task_switched_in(void);
+
+#ifndef traceTASK_SWITCHED_IN
+#define traceTASK_SWITCHED_IN() trace_task_switched_in()
+#endif
+
+#endif  // __TRACE_HOOKS_H__
@@ -0,0 +1,71 @@
+#include "ui_msg.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "heap_tag.h"
+
+#define TAG "UI_MSG"
+#define CHECK_ALLOC(ptr)                                    \
+  do {                                                      \
+    if (ptr == NULL) {                                      \
+      ESP_LOGE(TAG, "Failed to allocate memory: %s", #ptr); \
+      abort();                                              \
+    }                                                       \
+  } while (0)
+
+ui_msg_queue_t *ui_msg_queue_create(void) {
+  ui_msg_queue_t *q =
+      heap_tag_calloc(HEAP_TAG_LCD, 1, sizeof(ui_msg_queue_t), MALLOC_CAP_8BIT);
+  CHECK_ALLOC(q);
+  for (uint32_t i = 0; i < UI_MSG_QUEUE_LEN; i++)
+    atomic_init(&q->slots[i].seq, i);
+  atomic_init(&q->head, 0);
+  atomic_init(&q->dropped, 0);
+  return q;
+}
+
+bool ui_msg_post(ui_msg_queue_t *q, ui_msg_t *msg) {
+  uint32_t pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+  ui_msg_slot_t *slot;
+
+  while (true) {
+    slot = &q->slots[pos & (UI_MSG_QUEUE_LEN - 1)];
+    uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    int32_t diff = (int32_t)(seq - pos);
+    if (diff == 0) {
+      // 슬롯이 비어 있음, head 선점 시도 (실패하면 pos가 갱신됨)
+      if (atomic_compare_exchange_weak_explicit(&q->head, &pos, pos + 1,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed))
+        break;
+    } else if (diff < 0) {
+      // 소비자가 아직 이 슬롯을 비우지 않음 = 가득 참
+      atomic_fetch_add_explicit(&q->dropped, 1, memory_order_relaxed);
+      return false;
+    } else {
+      pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+    }
+  }
+
+  msg->posted_us = esp_timer_get_time();
+  slot->msg = *msg;
+  atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+  return true;
+}
+
+bool ui_msg_pop(ui_msg_queue_t *q, ui_msg_t *msg) {
+  ui_msg_slot_t *slot = &q->slots[q->tail & (UI_MSG_QUEUE_LEN - 1)];
+  uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+  if ((int32_t)(seq - (q->tail + 1)) < 0) return false;
+
+  *msg = slot->msg;
+  atomic_store_explicit(&slot->seq, q->tail + UI_MSG_QUEUE_LEN,
+                        memory_order_release);
+  q->tail++;
+
+  int64_t latency = esp_timer_get_time() - msg->posted_us;
+  q->latency_count++;
+  q->latency_total_us += latency;
+  if (latency > q->latency_max_us) q->latency_max_us = latency;
+  return true;
+}
@@ -0,0 +1,62 @@
+#ifndef __UI_MSG_H__
+#define __UI_MSG_H__
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define UI_MSG_QUEUE_LEN 16  // must be a power of two
+
+typedef enum {
+  UI_MSG_STATS,
+  UI_MSG_PROF,
+  UI_MSG_SYSMON,  // new sysmon sample, no payload
+  UI_MSG_SCREEN,
+} ui_msg_type_t;
+
+// fixed-size message, anything larger than this should not go through the UI
+typedef struct {
+  uint8_t type;
+  int64_t posted_us;
+  union {
+    struct {
+      uint8_t mem_pct;
+      uint8_t frag_pct;  // heap free space not in the largest block
+      float temperature;
+    } stats;
+    struct {
+      uint16_t fps;
+      uint32_t frame_us;  // average render + refresh time
+    } prof;
+    struct {
+      bool monitor;  // show the sysmon screen instead of the render one
+    } screen;
+  };
+} ui_msg_t;
+
+typedef struct {
+  _Atomic uint32_t seq;
+  ui_msg_t msg;
+} ui_msg_slot_t;
+
+/*
+ * bounded lock-free MPSC ring (per-slot sequence numbers). any task may post,
+ * only lv_timer_handler_task pops, so it stays the single owner of LVGL
+ * objects. posting never blocks: a full ring drops the message.
+ */
+typedef struct {
+  ui_msg_slot_t slots[UI_MSG_QUEUE_LEN];
+  _Atomic uint32_t head;     // producers
+  uint32_t tail;             // consumer only
+  _Atomic uint32_t dropped;  // posts rejected because the ring was full
+  // post -> pop latency, consumer only
+  uint32_t latency_count;
+  int64_t latency_total_us;
+  int64_t latency_max_us;
+} ui_msg_queue_t;
+
+ui_msg_queue_t *ui_msg_queue_create(void);
+bool ui_msg_post(ui_msg_queue_t *q, ui_msg_t *msg);
+bool ui_msg_pop(ui_msg_queue_t *q, ui_msg_t *msg);
+
+#endif  // __UI_MSG_H__
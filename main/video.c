@@ -0,0 +1,149 @@
+#include "video.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "packbits.h"
+
+static uint16_t get_u16(const uint8_t *p) { return p[0] | p[1] << 8; }
+
+static uint32_t get_u32(const uint8_t *p) {
+  return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static void put_u16(uint8_t *p, uint16_t v) {
+  p[0] = v;
+  p[1] = v >> 8;
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+  put_u16(p, v);
+  put_u16(p + 2, v >> 16);
+}
+
+video_err_t video_open(video_t *v, const uint8_t *data, size_t len,
+                       uint16_t width, uint16_t height) {
+  if (len < VIDEO_HEADER_SIZE || memcmp(data, VIDEO_MAGIC, 4) != 0)
+    return VIDEO_ERR_FORMAT;
+  video_info_t *info = &v->info;
+  info->width = get_u16(data + 4);
+  info->height = get_u16(data + 6);
+  info->fps = get_u16(data + 8);
+  info->key_interval = get_u16(data + 10);
+  info->frame_count = get_u32(data + 12);
+  info->data_size = get_u32(data + 16);
+  if (info->data_size > len - VIDEO_HEADER_SIZE || info->fps == 0 ||
+      info->frame_count == 0)
+    return VIDEO_ERR_FORMAT;
+  if (info->width != width || info->height != height)
+    return VIDEO_ERR_SIZE;
+  v->data = data + VIDEO_HEADER_SIZE;
+  video_rewind(v);
+  return VIDEO_OK;
+}
+
+void video_rewind(video_t *v) {
+  v->pos = v->data;
+  v->frame = 0;
+  v->synced = false;
+}
+
+/*
+ * decodes the next frame into pages (the previous frame must still be
+ * there) and returns the mask of page rows that changed. only those rows
+ * are written, unchanged rows of a delta are not even read.
+ */
+int video_next(video_t *v, uint8_t *pages) {
+  if (v->frame >= v->info.frame_count) return VIDEO_ERR_END;
+  const uint8_t *end = v->data + v->info.data_size;
+  if (end - v->pos < VIDEO_FRAME_HEADER_SIZE) return VIDEO_ERR_FORMAT;
+  uint8_t flags = v->pos[0];
+  uint8_t mask = v->pos[1];
+  uint16_t size = get_u16(v->pos + 2);
+  const uint8_t *src = v->pos + VIDEO_FRAME_HEADER_SIZE;
+  if (end - src < size) return VIDEO_ERR_FORMAT;
+
+  bool key = flags & VIDEO_FLAG_KEY;
+  if (!key && !v->synced) return VIDEO_ERR_FORMAT;
+  uint32_t row = v->info.width;
+  size_t used = 0;
+  for (int page = 0; page < v->info.height / 8; page++) {
+    if (!(mask >> page & 1)) continue;
+    uint8_t *dst = pages + row * page;
+    // 키 프레임은 0에 XOR해 그대로 복사되게 함
+    if (key) memset(dst, 0, row);
+    size_t n = packbits_unpack_xor(src + used, size - used, dst, row);
+    if (n == 0) return VIDEO_ERR_FORMAT;
+    used += n;
+  }
+  if (used != size) return VIDEO_ERR_FORMAT;
+  v->synced |= key;
+  v->pos = src + size;
+  v->frame++;
+  return mask;
+}
+
+bool video_encoder_init(video_encoder_t *enc, uint16_t width, uint16_t height,
+                        uint16_t fps, uint16_t key_interval) {
+  if (height % 8 || height / 8 > VIDEO_MAX_PAGES || fps == 0 ||
+      key_interval == 0)
+    return false;
+  memset(enc, 0, sizeof(*enc));
+  enc->info.width = width;
+  enc->info.height = height;
+  enc->info.fps = fps;
+  enc->info.key_interval = key_interval;
+  enc->page_bytes = width * height / 8;
+  enc->prev = calloc(enc->page_bytes, 1);
+  return enc->prev != NULL;
+}
+
+size_t video_frame_max_size(const video_encoder_t *enc) {
+  return VIDEO_FRAME_HEADER_SIZE +
+         enc->info.height / 8 * PACKBITS_MAX_SIZE(enc->info.width);
+}
+
+// out에 프레임 레코드를 쓰고 길이를 돌려줌, 최대 video_frame_max_size
+size_t video_encode_frame(video_encoder_t *enc, const uint8_t *pages,
+                          uint8_t *out) {
+  uint32_t row = enc->info.width;
+  bool key = enc->info.frame_count % enc->info.key_interval == 0;
+  uint8_t delta[row];
+  uint8_t mask = 0;
+  size_t size = 0;
+  uint8_t *payload = out + VIDEO_FRAME_HEADER_SIZE;
+  for (int page = 0; page < enc->info.height / 8; page++) {
+    const uint8_t *cur = pages + row * page;
+    const uint8_t *prev = enc->prev + row * page;
+    bool changed = key;
+    for (uint32_t x = 0; x < row; x++) {
+      delta[x] = key ? cur[x] : cur[x] ^ prev[x];
+      changed |= delta[x] != 0;
+    }
+    if (!changed) continue;
+    mask |= 1 << page;
+    size += packbits_pack(delta, row, payload + size);
+  }
+  out[0] = key ? VIDEO_FLAG_KEY : 0;
+  out[1] = mask;
+  put_u16(out + 2, size);
+  memcpy(enc->prev, pages, enc->page_bytes);
+  enc->info.frame_count++;
+  enc->info.data_size += VIDEO_FRAME_HEADER_SIZE + size;
+  return VIDEO_FRAME_HEADER_SIZE + size;
+}
+
+void video_write_header(const video_encoder_t *enc, uint8_t *out) {
+  memcpy(out, VIDEO_MAGIC, 4);
+  put_u16(out + 4, enc->info.width);
+  put_u16(out + 6, enc->info.height);
+  put_u16(out + 8, enc->info.fps);
+  put_u16(out + 10, enc->info.key_interval);
+  put_u32(out + 12, enc->info.frame_count);
+  put_u32(out + 16, enc->info.data_size);
+}
+
+void video_encoder_free(video_encoder_t *enc) {
+  free(enc->prev);
+  enc->prev = NULL;
+}
@@ -0,0 +1,76 @@
+#ifndef __VIDEO_H__
+#define __VIDEO_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * 1bpp video container for the SSD1306, portable (plain libc) so the host
+ * encoder (tools/video_encode.c) and benchmark share it with the player.
+ * frames are stored in the panel's page layout (byte = 8 vertical pixels,
+ * LCD_WIDTH bytes per page row), so decoding writes straight into lcd_buf.
+ * all fields little endian:
+ *
+ *   "WFV1", u16 width, u16 height, u16 fps, u16 key_interval,
+ *   u32 frame_count, u32 data_size
+ *   frame_count x { u8 flags, u8 page_mask, u16 size, payload[size] }
+ *
+ * the payload has one packbits stream per page row set in page_mask. a key
+ * frame sets every page and holds the pixels, a delta frame holds the XOR
+ * against the previous frame for the rows that changed.
+ */
+
+#define VIDEO_MAGIC "WFV1"
+#define VIDEO_HEADER_SIZE 20
+#define VIDEO_FRAME_HEADER_SIZE 4
+#define VIDEO_FLAG_KEY 0x01
+#define VIDEO_MAX_PAGES 8  // page_mask is one byte
+#define VIDEO_DEFAULT_FPS 30
+#define VIDEO_DEFAULT_KEY_INTERVAL 60
+
+typedef enum {
+  VIDEO_OK = 0,
+  VIDEO_ERR_FORMAT = -1,
+  VIDEO_ERR_SIZE = -2,  // not the panel's resolution
+  VIDEO_ERR_END = -3,   // no frames left
+} video_err_t;
+
+typedef struct {
+  uint16_t width;
+  uint16_t height;
+  uint16_t fps;
+  uint16_t key_interval;
+  uint32_t frame_count;
+  uint32_t data_size;  // frame records after the header
+} video_info_t;
+
+typedef struct {
+  video_info_t info;
+  const uint8_t *data;  // first frame record, e.g. in mmapped flash
+  const uint8_t *pos;   // next frame record
+  uint32_t frame;       // index of the next frame
+  bool synced;          // a key frame has been decoded since the rewind
+} video_t;
+
+// encoder state, prev holds the last frame in page layout
+typedef struct {
+  video_info_t info;
+  uint8_t *prev;
+  uint32_t page_bytes;  // width * height / 8
+} video_encoder_t;
+
+video_err_t video_open(video_t *v, const uint8_t *data, size_t len,
+                       uint16_t width, uint16_t height);
+void video_rewind(video_t *v);
+int video_next(video_t *v, uint8_t *pages);
+
+size_t video_frame_max_size(const video_encoder_t *enc);
+bool video_encoder_init(video_encoder_t *enc, uint16_t width, uint16_t height,
+                        uint16_t fps, uint16_t key_interval);
+size_t video_encode_frame(video_encoder_t *enc, const uint8_t *pages,
+                          uint8_t *out);
+void video_write_header(const video_encoder_t *enc, uint8_t *out);
+void video_encoder_free(video_encoder_t *enc);
+
+#endif  // __VIDEO_H__
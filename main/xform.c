@@ -0,0 +1,79 @@
+#include "xform.h"
+
+#ifdef ESP_PLATFORM
+// FPU가 없어 나눗셈 대신 테이블 역수를 씀
+#define XFORM_RECIP(w) fast_recip(w)
+#else
+// 호스트에서는 테이블 조회가 벡터화를 막으므로 그냥 나눔
+#define XFORM_RECIP(w) (1.0f / (w))
+#endif
+
+static inline float clamp_coord(float v) {
+  v = v < -XFORM_COORD_MAX ? -XFORM_COORD_MAX : v;
+  return v > XFORM_COORD_MAX ? XFORM_COORD_MAX : v;
+}
+
+/*
+ * branch free body: clipped vertices still go through the math with w forced
+ * to 1 and are tagged afterwards with a select, so every lane does the same
+ * work and the loop stays vectorizable.
+ */
+void xform_project(const mat34_t *m, const float *restrict x,
+                   const float *restrict y, const float *restrict z,
+                   uint32_t count, float near, int16_t *restrict out) {
+  const float m00 = m->m[0][0], m01 = m->m[0][1], m02 = m->m[0][2];
+  const float m03 = m->m[0][3], m10 = m->m[1][0], m11 = m->m[1][1];
+  const float m12 = m->m[1][2], m13 = m->m[1][3], m20 = m->m[2][0];
+  const float m21 = m->m[2][1], m22 = m->m[2][2], m23 = m->m[2][3];
+
+#pragma GCC unroll 4
+  // uint32_t 인덱스는 2 * i의 wraparound 때문에 벡터화되지 않음
+  for (int i = 0; i < (int)count; i++) {
+    float px = m00 * x[i] + m01 * y[i] + m02 * z[i] + m03;
+    float py = m10 * x[i] + m11 * y[i] + m12 * z[i] + m13;
+    float pw = m20 * x[i] + m21 * y[i] + m22 * z[i] + m23;
+    int clipped = pw < near;
+    float inv_w = XFORM_RECIP(clipped ? 1.0f : pw);
+    int32_t sx = (int32_t)clamp_coord(px * inv_w);
+    int32_t sy = (int32_t)clamp_coord(py * inv_w);
+    out[2 * i] = clipped ? XFORM_CLIPPED : sx;
+    out[2 * i + 1] = sy;
+  }
+}
+
+/*
+ * same projection for points that are plotted straight into a 1bpp frame
+ * (row major, MSB first) without keeping screen coordinates. off screen and
+ * clipped points fold into a single unsigned range test. every step-th point
+ * is taken, returns the number of pixels set.
+ */
+uint32_t xform_plot_points(const mat34_t *m, const int16_t *restrict x,
+                           const int16_t *restrict y, const int16_t *restrict z,
+                           uint32_t count, uint32_t step, float near,
+                           uint8_t *restrict fb, int width, int height) {
+  const float m00 = m->m[0][0], m01 = m->m[0][1], m02 = m->m[0][2];
+  const float m03 = m->m[0][3], m10 = m->m[1][0], m11 = m->m[1][1];
+  const float m12 = m->m[1][2], m13 = m->m[1][3], m20 = m->m[2][0];
+  const float m21 = m->m[2][1], m22 = m->m[2][2], m23 = m->m[2][3];
+  const int stride = width / 8;
+  uint32_t plotted = 0;
+
+#pragma GCC unroll 4
+  for (int i = 0; i < (int)count; i += step) {
+    float fx = x[i], fy = y[i], fz = z[i];
+    float px = m00 * fx + m01 * fy + m02 * fz + m03;
+    float py = m10 * fx + m11 * fy + m12 * fz + m13;
+    float pw = m20 * fx + m21 * fy + m22 * fz + m23;
+    int clipped = pw < near;
+    float inv_w = XFORM_RECIP(clipped ? 1.0f : pw);
+    int32_t sx = (int32_t)clamp_coord(px * inv_w);
+    int32_t sy = (int32_t)clamp_coord(py * inv_w);
+    sx = clipped ? -1 : sx;
+    // 음수는 unsigned로 바꾸면 커지므로 비교 한 번으로 양쪽 경계를 거름
+    if ((uint32_t)sx >= (uint32_t)width || (uint32_t)sy >= (uint32_t)height)
+      continue;
+    fb[sy * stride + (sx >> 3)] |= 0x80 >> (sx & 7);
+    plotted++;
+  }
+  return plotted;
+}
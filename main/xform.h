@@ -0,0 +1,41 @@
+#ifndef __XFORM_H__
+#define __XFORM_H__
+
+#include <stdint.h>
+
+#include "math3d.h"
+
+/*
+ * batched vertex transform. positions are kept as separate x/y/z streams
+ * (structure of arrays) so the projection loop has no strided loads and can
+ * be vectorized on the host or unrolled on the C3. the output is packed
+ * int16 screen coordinates, x and y interleaved per vertex.
+ */
+
+// x of a vertex behind the near plane
+#define XFORM_CLIPPED INT16_MIN
+// keeps off screen coordinates far from int16 overflow
+#define XFORM_COORD_MAX 16383.0f
+
+typedef struct {
+  float *x;
+  float *y;
+  float *z;
+  uint32_t count;
+} vertex_soa_t;
+
+static inline void vertex_soa_set(vertex_soa_t *soa, uint32_t i, vec3_t v) {
+  soa->x[i] = v.x;
+  soa->y[i] = v.y;
+  soa->z[i] = v.z;
+}
+
+void xform_project(const mat34_t *m, const float *restrict x,
+                   const float *restrict y, const float *restrict z,
+                   uint32_t count, float near, int16_t *restrict out);
+uint32_t xform_plot_points(const mat34_t *m, const int16_t *restrict x,
+                           const int16_t *restrict y, const int16_t *restrict z,
+                           uint32_t count, uint32_t step, float near,
+                           uint8_t *restrict fb, int width, int height);
+
+#endif  // __XFORM_H__
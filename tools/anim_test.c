@@ -0,0 +1,134 @@
+/*
+ * host check of the animation engine (main/anim.c) on a simulated clock.
+ *
+ *   make anim_test && ./anim_test      # also part of make check
+ *
+ * the clock is injected through anim_clock_init, so every value below is
+ * evaluated at an exact time and has to come out the same on every run.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "anim.h"
+
+#define HOUR_US (3600LL * 1000000)
+
+static int64_t sim_now_us;
+static int failures;
+
+static int64_t sim_clock(void) { return sim_now_us; }
+
+// anim_clock_init은 시계를 주지 않으면 이 함수를 씀, 여기서는 불리면 안 됨
+int64_t esp_timer_get_time(void) {
+  fprintf(stderr, "esp_timer_get_time called\n");
+  abort();
+}
+
+static void check(int ok, const char *what) {
+  printf("%s %s\n", ok ? "ok  " : "FAIL", what);
+  if (!ok) failures++;
+}
+
+static void check_near(float got, float want, float tol, const char *what) {
+  if (fabsf(got - want) > tol) printf("     got %.7f, want %.7f\n", got, want);
+  check(fabsf(got - want) <= tol, what);
+}
+
+static void test_clock(void) {
+  anim_clock_t clock;
+  sim_now_us = 5000000;
+  anim_clock_init(&clock, sim_clock);
+  check(clock.t_us == 0 && anim_clock_update(&clock) == 0,
+        "clock starts at 0 whatever the source reads");
+  sim_now_us += 33333;
+  check(anim_clock_update(&clock) == 33333, "clock follows the source");
+  sim_now_us += HOUR_US;
+  check(anim_clock_update(&clock) == HOUR_US + 33333 &&
+            clock.t_us == HOUR_US + 33333,
+        "clock keeps microseconds after an hour");
+}
+
+// 기대값은 128비트 정수로 따로 계산, 나눗셈 두 번의 내림 차이로 1 BAM까지 허용
+static int spin_matches(const anim_spin_t *spin, int64_t t_us) {
+  bam_t got[3];
+  anim_spin_eval(spin, t_us, got);
+  for (int i = 0; i < 3; i++) {
+    __int128 turn = (__int128)spin->rate[i] * t_us / 1000000;
+    bam_t want = spin->phase[i] + (bam_t)(uint64_t)turn;
+    int32_t err = (int32_t)(got[i] - want);
+    if (err < -1 || err > 1) return 0;
+  }
+  return 1;
+}
+
+static void test_spin(void) {
+  anim_spin_t spin;
+  // float 라디안은 정확하지 않으므로 환산은 ppm 단위로만 비교
+  anim_spin_init(&spin, 2 * M_PI, M_PI, -M_PI / 2);
+  check(llabs(spin.rate[0] - 4294967296LL) < 4295 &&
+            llabs(spin.rate[1] - 2147483648LL) < 2148 &&
+            llabs(spin.rate[2] + 1073741824LL) < 1074,
+        "rad/s converts to BAM/s within 1 ppm");
+
+  spin.rate[0] = 4294967296LL;
+  spin.rate[1] = 2147483648LL;
+  spin.rate[2] = -1073741824LL;
+  bam_t a[3];
+  spin.phase[1] = 0x12345678;
+  anim_spin_eval(&spin, 250000, a);
+  check(a[0] == 0x40000000u && a[1] == 0x12345678u + 0x20000000u &&
+            a[2] == (bam_t)-0x10000000,
+        "quarter second is an exact fraction of a turn");
+  bam_t b[3];
+  anim_spin_eval(&spin, HOUR_US + 250000, b);
+  check(a[0] == b[0] && a[1] == b[1] && a[2] == b[2],
+        "whole turns after an hour leave no residue");
+
+  // 렌더러와 같은 느리고 어중간한 속도로 한 시간 동안 30fps 시각마다 비교
+  anim_spin_init(&spin, 0.13 / 0.016, 0.05 / 0.016, 0.04 / 0.016);
+  int ok = 1;
+  for (int64_t t = 0; t <= HOUR_US && ok; t += 33333)
+    ok = spin_matches(&spin, t);
+  check(ok, "spin stays within 1 BAM of exact for an hour at 30 fps");
+}
+
+static void test_sin(void) {
+  check_near(anim_sin(0), 0, 1e-7f, "sin 0");
+  check_near(anim_sin(0x40000000u), 1, 1e-7f, "sin quarter turn");
+  check_near(anim_cos(0x80000000u), -1, 1e-7f, "cos half turn");
+  float worst = 0;
+  for (uint64_t a = 0; a < 1ULL << 32; a += 0x10001) {
+    float err = fabsf(anim_sin(a) - sinf(a * BAM_TO_RAD));
+    if (err > worst) worst = err;
+  }
+  check_near(worst, 0, 1e-5f, "sin table error over a full turn");
+}
+
+static void test_track(void) {
+  // render.c의 구 위아래 움직임과 같은 키
+  static const anim_key_t keys[] = {
+      {0.0, 0.0}, {0.25, 0.4}, {0.5, 0.0}, {0.75, -0.4}};
+  anim_track_t track;
+  anim_track_build(&track, keys, 4, ANIM_TRACK_MAX_SAMPLES, 3000000);
+  check(track.count == ANIM_TRACK_MAX_SAMPLES, "track keeps the sample count");
+  check_near(anim_track_eval(&track, 0), 0, 1e-6f, "track at 0");
+  check_near(anim_track_eval(&track, 750000), 0.4f, 1e-6f, "track at a key");
+  check_near(anim_track_eval(&track, 2250000), -0.4f, 1e-6f,
+             "track at the last key");
+  // 키 사이 smoothstep 가운데는 두 값의 평균
+  check_near(anim_track_eval(&track, 375000), 0.2f, 0.01f,
+             "track between keys");
+  check(anim_track_eval(&track, 750000) ==
+            anim_track_eval(&track, HOUR_US + 750000),
+        "track repeats exactly every period");
+}
+
+int main(void) {
+  test_clock();
+  test_spin();
+  test_sin();
+  test_track();
+  if (failures) printf("%d failed\n", failures);
+  return failures != 0;
+}
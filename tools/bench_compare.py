@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""compare benchmark results against a stored baseline.
+
+    tools/sim/wireframe_bench > bench.json        # or an idf.py monitor log
+    tools/bench_compare.py baseline.json bench.json
+
+both arguments may be whole console logs, the last line starting with
+{"bench": is used. kernels are matched by scene and name and compared on
+the median cycle count (--stat min is steadier on a busy host). the exit
+status is 1 when any kernel got slower by more than --threshold percent,
+so it can gate a CI step.
+"""
+import argparse
+import json
+import sys
+
+MARK = '{"bench":'
+
+
+def load(path):
+    result = None
+    with open(path) as f:
+        for line in f:
+            i = line.find(MARK)
+            if i >= 0:
+                result = json.loads(line[i:])
+    if result is None:
+        sys.exit("%s: no benchmark result found" % path)
+    return result
+
+
+def index(result):
+    return {(r["scene"], r["kernel"]): r for r in result["results"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="allowed slowdown in percent (10)")
+    parser.add_argument("--stat", choices=("min", "median", "mean"),
+                        default="median")
+    args = parser.parse_args()
+    base, cur = load(args.baseline), load(args.current)
+    if (base["target"], base["cpu_mhz"]) != (cur["target"], cur["cpu_mhz"]):
+        print("warning: baseline is %s@%dMHz, current is %s@%dMHz" %
+              (base["target"], base["cpu_mhz"], cur["target"],
+               cur["cpu_mhz"]), file=sys.stderr)
+    base, cur = index(base), index(cur)
+    regressions = 0
+    print("%-14s %-8s %10s %10s %8s" %
+          ("scene", "kernel", "baseline", "current", "change"))
+    for key, r in cur.items():
+        if key not in base:
+            print("%-14s %-8s %10s %10d %8s" %
+                  (key + ("-", r[args.stat], "new")))
+            continue
+        old = base[key][args.stat]
+        change = (r[args.stat] - old) * 100.0 / old if old else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print("%-14s %-8s %10d %10d %+7.1f%%%s" %
+              (key + (old, r[args.stat], change, flag)))
+    for key in base.keys() - cur.keys():
+        print("%-14s %-8s missing from current results" % key)
+    if regressions:
+        sys.exit("%d kernel(s) slower than %.0f%%" %
+                 (regressions, args.threshold))
+
+
+if __name__ == "__main__":
+    main()
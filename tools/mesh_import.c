@@ -0,0 +1,82 @@
+/*
+ * converts a wavefront obj into the mesh blob the renderer embeds
+ * (main/mesh_import.h), keeping only the feature edges.
+ *
+ *   make mesh_import
+ *   ./mesh_import [-a crease_deg] in.obj out.wfm
+ *
+ * an edge is kept when it is a boundary or its two faces meet at more than
+ * crease_deg (default 20), so flat quad diagonals and smooth tessellation
+ * seams disappear from the wireframe.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mesh_import.h"
+
+static char *read_file(const char *path, size_t *len) {
+  FILE *f = fopen(path, "rb");
+  if (!f) return NULL;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  char *buf = malloc(size + 1);
+  if (buf && fread(buf, 1, size, f) != (size_t)size) {
+    free(buf);
+    buf = NULL;
+  }
+  fclose(f);
+  if (buf) buf[size] = '\0';
+  *len = size;
+  return buf;
+}
+
+static int usage(void) {
+  fprintf(stderr, "usage: mesh_import [-a crease_deg] in.obj out.wfm\n");
+  return 2;
+}
+
+int main(int argc, char **argv) {
+  float crease = MESH_DEFAULT_CREASE_DEG;
+  int arg = 1;
+  if (arg + 1 < argc && strcmp(argv[arg], "-a") == 0) {
+    crease = strtof(argv[arg + 1], NULL);
+    arg += 2;
+  }
+  if (argc - arg != 2) return usage();
+
+  size_t len;
+  char *text = read_file(argv[arg], &len);
+  if (!text) {
+    perror(argv[arg]);
+    return 1;
+  }
+  mesh_t mesh;
+  mesh_err_t err = mesh_parse_obj(text, len, &mesh);
+  free(text);
+  if (err == MESH_OK) err = mesh_extract_edges(&mesh, crease);
+  if (err != MESH_OK) {
+    fprintf(stderr, "%s: import failed (%d)\n", argv[arg], err);
+    mesh_free(&mesh);
+    return 1;
+  }
+
+  size_t size = mesh_blob_size(&mesh);
+  uint8_t *blob = malloc(size);
+  mesh_write_blob(&mesh, blob);
+  FILE *out = fopen(argv[arg + 1], "wb");
+  if (!out || fwrite(blob, 1, size, out) != size) {
+    perror(argv[arg + 1]);
+    return 1;
+  }
+  fclose(out);
+
+  printf("%s: %u vertices, %u faces, %u/%u edges kept (crease %.1f deg), "
+         "%zu bytes\n",
+         argv[arg + 1], mesh.vertex_count, mesh.face_count, mesh.edge_count,
+         mesh.unique_edges, crease, size);
+  free(blob);
+  mesh_free(&mesh);
+  return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * host check of the mesh importer limits (main/mesh_import.c).
+ *
+ *   make mesh_test && ./mesh_test      # also part of make check
+ *
+ * the blob header stores the vertex, edge and face counts as u16, so an obj
+ * that goes over 0xffff in any of them has to fail with MESH_ERR_RANGE
+ * instead of producing a blob with a truncated count. a mesh right at the
+ * limits must still import and read back with the same counts.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mesh_import.h"
+
+static int failures;
+
+static void check(int ok, const char *what) {
+  printf("%s %s\n", ok ? "ok  " : "FAIL", what);
+  if (!ok) failures++;
+}
+
+typedef struct {
+  char *text;
+  size_t len, cap;
+} obj_t;
+
+static void obj_line(obj_t *o, const char *fmt, double a, double b,
+                     double c) {
+  if (o->cap - o->len < 64) {
+    o->cap = o->cap ? o->cap * 2 : 1 << 16;
+    o->text = realloc(o->text, o->cap);
+    if (!o->text) abort();
+  }
+  o->len += snprintf(o->text + o->len, o->cap - o->len, fmt, a, b, c);
+}
+
+static mesh_err_t import(obj_t *o, mesh_t *mesh) {
+  mesh_err_t err = mesh_parse_obj(o->text, o->len, mesh);
+  if (err == MESH_OK) err = mesh_extract_edges(mesh, MESH_DEFAULT_CREASE_DEG);
+  free(o->text);
+  *o = (obj_t){0};
+  return err;
+}
+
+static void test_vertices(void) {
+  obj_t o = {0};
+  mesh_t mesh;
+  for (int i = 0; i <= MESH_MAX_VERTICES; i++)
+    obj_line(&o, "v %g %g %g\n", i, 0, 0);
+  check(import(&o, &mesh) == MESH_ERR_RANGE, "0x10000 vertices rejected");
+  mesh_free(&mesh);
+}
+
+// 같은 삼각형을 count번 반복, 변은 3개뿐
+static mesh_err_t repeated_faces(uint32_t count, mesh_t *mesh) {
+  obj_t o = {0};
+  obj_line(&o, "v %g %g %g\n", 0, 0, 0);
+  obj_line(&o, "v %g %g %g\n", 1, 0, 0);
+  obj_line(&o, "v %g %g %g\n", 0, 1, 0);
+  for (uint32_t i = 0; i < count; i++) obj_line(&o, "f %g %g %g\n", 1, 2, 3);
+  return import(&o, mesh);
+}
+
+static void test_faces(void) {
+  mesh_t mesh;
+  check(repeated_faces(MESH_MAX_FACES, &mesh) == MESH_OK,
+        "0xffff faces accepted");
+  check(mesh.face_count == MESH_MAX_FACES, "face count kept");
+  mesh_free(&mesh);
+  check(repeated_faces(MESH_MAX_FACES + 1, &mesh) == MESH_ERR_RANGE,
+        "0x10000 faces rejected");
+  mesh_free(&mesh);
+}
+
+/*
+ * fan around vertex 1 whose rim alternates between z = 1 and z = -1, so
+ * neighbouring faces fold against each other and every spoke is kept as a
+ * crease next to the rim edges: 2 * faces + 1 edges from faces + 2 vertices
+ */
+static mesh_err_t zigzag_fan(uint32_t faces, mesh_t *mesh) {
+  obj_t o = {0};
+  obj_line(&o, "v %g %g %g\n", 0, 0, 0);
+  for (uint32_t i = 0; i <= faces; i++)
+    obj_line(&o, "v %g %g %g\n", 1, i * 1e-3, i % 2 ? -1 : 1);
+  for (uint32_t i = 0; i < faces; i++)
+    obj_line(&o, "f %g %g %g\n", 1, i + 2, i + 3);
+  return import(&o, mesh);
+}
+
+static void test_edges(void) {
+  mesh_t mesh;
+  uint32_t faces = (MESH_MAX_EDGES - 1) / 2;
+  check(zigzag_fan(faces, &mesh) == MESH_OK, "0xffff edges accepted");
+  check(mesh.edge_count == MESH_MAX_EDGES, "every fan edge kept");
+
+  size_t size = mesh_blob_size(&mesh);
+  uint8_t *data = malloc(size);
+  mesh_write_blob(&mesh, data);
+  mesh_blob_t blob;
+  check(mesh_read_blob(data, size, &blob) == MESH_OK &&
+            blob.vertex_count == mesh.vertex_count &&
+            blob.edge_count == mesh.edge_count &&
+            blob.face_count == mesh.face_count,
+        "blob at the edge limit reads back");
+  free(data);
+  mesh_free(&mesh);
+
+  check(zigzag_fan(faces + 1, &mesh) == MESH_ERR_RANGE,
+        "0x10001 edges rejected");
+  mesh_free(&mesh);
+}
+
+int main(void) {
+  test_vertices();
+  test_faces();
+  test_edges();
+  if (failures) printf("%d failed\n", failures);
+  return failures != 0;
+}
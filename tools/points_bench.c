@@ -0,0 +1,72 @@
+/*
+ * host benchmark for the point cloud path (main/points.c + main/xform.c).
+ *
+ *   make points_bench
+ *   ./points_bench [points] [frames]
+ *
+ * plots a spinning random cloud into a 128x64 frame at every decimation
+ * step and reports frames/s. the device target is 5000 points at 30 fps,
+ * there the render task logs the chosen step once a second.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "heap_tag.h"
+#include "points.h"
+
+#define WIDTH 128
+#define HEIGHT 64
+
+// heap_tag.c는 LVGL에 묶여 있어 여기서는 태그 없이 malloc으로 보냄
+void *heap_tag_calloc(heap_tag_t tag, size_t n, size_t size, uint32_t caps) {
+  return calloc(n, size);
+}
+
+void heap_tag_free(heap_tag_t tag, void *ptr) { free(ptr); }
+
+static double now_s(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+  int count = argc > 1 ? atoi(argv[1]) : 5000;
+  int frames = argc > 2 ? atoi(argv[2]) : 20000;
+
+  point_cloud_t pc;
+  if (!point_cloud_init(&pc, count, 4.0f)) return 1;
+  srand(1);
+  for (int i = 0; i < count; i++) {
+    vec3_t v = {(float)rand() / RAND_MAX * 6 - 3,
+                (float)rand() / RAND_MAX * 6 - 3,
+                (float)rand() / RAND_MAX * 6 - 3};
+    point_cloud_set(&pc, i, v);
+  }
+  static uint8_t fb[WIDTH * HEIGHT / 8];
+
+  for (int step = 1; step <= 4; step *= 2) {
+    pc.step = step;
+    long checksum = 0;
+    double start = now_s();
+    for (int f = 0; f < frames; f++) {
+      // 128x64, 수평 75도 카메라를 z = -8에 둔 것과 같은 투영에 y축 회전
+      float a = f * 0.01f, c = cosf(a), s = sinf(a);
+      const mat34_t m = {{{83.4f * c + 64 * s, 0, -83.4f * s + 64 * c, 512},
+                          {32 * s, -83.4f, 32 * c, 256},
+                          {s, 0, c, 8}}};
+      for (int i = 0; i < (int)sizeof(fb); i++) fb[i] = 0;
+      point_cloud_draw(&pc, &m, 0.1f, fb, WIDTH, HEIGHT);
+      checksum += pc.plotted;
+    }
+    double elapsed = now_s() - start;
+    printf("points: %d, step 1/%d: %.0f frames/s, %.1f ns/point "
+           "(%ld plotted)\n",
+           count, step, frames / elapsed,
+           elapsed / frames / ((double)count / step) * 1e9, checksum);
+  }
+  point_cloud_free(&pc);
+  return 0;
+}
@@ -0,0 +1,163 @@
+/*
+ * host check of the incremental rotation path (main/rotation.c).
+ *
+ *   make rotation_test && ./rotation_test [seconds]   # also in make check
+ *
+ * spins the four render.c objects for an hour of 30 fps frames through
+ * rotation_advance. the orthogonality error seen before each
+ * renormalization must stay under ROTATION_ORTHO_ERROR_LIMIT, the pose must
+ * stay close to the exact delta power taken in double precision, and a
+ * stall longer than ROTATION_MAX_STEPS must land on the pose an unstalled
+ * run reaches at the same time.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "rotation.h"
+
+#define PERIOD_US 33333
+#define OBJECTS 4
+// float delta의 반올림은 시간에 비례해 쌓임, 한 시간에 약 2e-3 rad로
+// 반지름 30px 물체에서 0.06px
+#define DRIFT_LIMIT_RAD_PER_HOUR 5e-3
+#define STALL_LIMIT_RAD 1e-4
+
+// anim.c가 참조하지만 여기서는 시각을 직접 넘기므로 불리지 않음
+int64_t esp_timer_get_time(void) { abort(); }
+
+static int64_t zero_clock(void) { return 0; }
+
+typedef struct {
+  double m[3][3];
+} dmat3_t;
+
+static dmat3_t dmat_from(const mat3_t *f) {
+  dmat3_t d;
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) d.m[i][j] = f->m[i][j];
+  return d;
+}
+
+static dmat3_t dmat_mul(const dmat3_t *a, const dmat3_t *b) {
+  dmat3_t r;
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++)
+      r.m[i][j] = a->m[i][0] * b->m[0][j] + a->m[i][1] * b->m[1][j] +
+                  a->m[i][2] * b->m[2][j];
+  return r;
+}
+
+// 작은 각도에서 |A - B|_F = sqrt(2) theta, acos(trace)보다 float에 덜 민감
+static double angle_between(const mat3_t *a, const dmat3_t *b) {
+  double sum = 0;
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) {
+      double d = a->m[i][j] - b->m[i][j];
+      sum += d * d;
+    }
+  return sqrt(sum / 2);
+}
+
+// rotation.c build_delta와 같은 각도를 double 삼각함수로
+static dmat3_t exact_delta(const anim_spin_t *spin) {
+  double s[3], c[3];
+  for (int i = 0; i < 3; i++) {
+    bam_t angle = (bam_t)(spin->rate[i] * PERIOD_US / 1000000);
+    double rad = (int32_t)angle * (2 * M_PI / 4294967296.0);
+    s[i] = sin(rad);
+    c[i] = cos(rad);
+  }
+  return (dmat3_t){{
+      {c[2] * c[1], c[2] * s[1] * s[0] - s[2] * c[0],
+       c[2] * s[1] * c[0] + s[2] * s[0]},
+      {s[2] * c[1], s[2] * s[1] * s[0] + c[2] * c[0],
+       s[2] * s[1] * c[0] - c[2] * s[0]},
+      {-s[1], c[1] * s[0], c[1] * c[0]},
+  }};
+}
+
+static dmat3_t dmat_pow(dmat3_t m, int64_t n) {
+  dmat3_t r = {{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}};
+  for (; n > 0; n >>= 1) {
+    if (n & 1) r = dmat_mul(&r, &m);
+    m = dmat_mul(&m, &m);
+  }
+  return r;
+}
+
+static double angle_between_f(const mat3_t *a, const mat3_t *b) {
+  dmat3_t d = dmat_from(b);
+  return angle_between(a, &d);
+}
+
+// render.c setup_render_data와 같은 각속도
+static void spin_init(anim_spin_t *spin, int i) {
+  anim_spin_init(spin, (0.1 + i * 0.01) / 0.016, (0.03 + i * 0.01) / 0.016,
+                 (0.02 + i * 0.01) / 0.016);
+}
+
+int main(int argc, char **argv) {
+  int64_t duration_us = (argc > 1 ? atoll(argv[1]) : 3600) * 1000000;
+  float ortho_error_max = 0;
+  double drift_max = 0;
+  int failures = 0;
+  // 사인 테이블은 시계를 만들 때 채워짐, render.c와 같은 순서
+  anim_clock_t clock;
+  anim_clock_init(&clock, zero_clock);
+
+  for (int obj = 0; obj < OBJECTS; obj++) {
+    anim_spin_t spin;
+    spin_init(&spin, obj);
+    rotation_t rot;
+    rotation_init(&rot, spin.phase);
+    rotation_advance(&rot, &spin, PERIOD_US, 0, &ortho_error_max);
+    dmat3_t start = dmat_from(&rot.orient);
+    for (int64_t t = PERIOD_US; t <= duration_us; t += PERIOD_US)
+      rotation_advance(&rot, &spin, PERIOD_US, t, &ortho_error_max);
+    // 같은 시작 자세에 정확한 delta^step, float 곱셈과 정규화의 누적만 남음
+    dmat3_t d = dmat_pow(exact_delta(&spin), rot.step);
+    dmat3_t ref = dmat_mul(&start, &d);
+    double drift = angle_between(&rot.orient, &ref);
+    if (drift > drift_max) drift_max = drift;
+  }
+  printf("%.0f s at 30 fps: ortho error max %.3g (limit %.3g), "
+         "drift %.3g rad\n",
+         duration_us / 1e6, ortho_error_max, ROTATION_ORTHO_ERROR_LIMIT,
+         drift_max);
+  if (ortho_error_max >= ROTATION_ORTHO_ERROR_LIMIT) {
+    printf("FAIL orthogonality error over the limit\n");
+    failures++;
+  }
+  double drift_limit = DRIFT_LIMIT_RAD_PER_HOUR * duration_us / 3.6e9;
+  if (drift_max >= drift_limit) {
+    printf("FAIL pose drifted more than %g rad\n", drift_limit);
+    failures++;
+  }
+
+  // 10초 멈춘 뒤에도 멈추지 않은 쪽과 같은 자세여야 함
+  anim_spin_t spin;
+  spin_init(&spin, 0);
+  rotation_t steady, stalled;
+  rotation_init(&steady, spin.phase);
+  rotation_init(&stalled, spin.phase);
+  rotation_advance(&steady, &spin, PERIOD_US, 0, &ortho_error_max);
+  rotation_advance(&stalled, &spin, PERIOD_US, 0, &ortho_error_max);
+  int64_t stall_from = 60 * 1000000, stall_to = 70 * 1000000;
+  double stall_err = 0;
+  for (int64_t t = PERIOD_US; t <= 120 * 1000000; t += PERIOD_US) {
+    rotation_advance(&steady, &spin, PERIOD_US, t, &ortho_error_max);
+    if (t <= stall_from || t >= stall_to)
+      rotation_advance(&stalled, &spin, PERIOD_US, t, &ortho_error_max);
+    if (t >= stall_to) {
+      double err = angle_between_f(&stalled.orient, &steady.orient);
+      if (err > stall_err) stall_err = err;
+    }
+  }
+  printf("10 s stall: %.3g rad from the unstalled pose\n", stall_err);
+  if (stall_err >= STALL_LIMIT_RAD) {
+    printf("FAIL stall left the pose more than %g rad off\n", STALL_LIMIT_RAD);
+    failures++;
+  }
+  return failures != 0;
+}
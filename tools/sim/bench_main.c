@@ -0,0 +1,15 @@
+#include <stdio.h>
+
+#include "bench.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "render.h"
+#include "sim.h"
+
+// 펌웨어의 부팅 벤치마크와 같은 코드, JSON 한 줄을 stdout으로
+int main(void) {
+  sim_time_init();
+  sim_task_init();
+  bench_run_all(stdout, "host", setup_render_data(NULL));
+  return 0;
+}
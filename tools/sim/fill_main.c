@@ -0,0 +1,85 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "camera.h"
+#include "render.h"
+#include "xform.h"
+
+/*
+ * host benchmark for the filled render mode.
+ *
+ *   make -C tools/sim fill_bench
+ *   tools/sim/fill_bench [frames] [out.pbm]
+ *
+ * renders four of render.c's uv spheres (the heaviest of the device's
+ * primitives) where the device scene puts its objects, turning about y, and
+ * shades them with render_fill_faces under render_fill_init's light. the
+ * frame rate is a lower bound for the real scene. the last frame can be
+ * written as a pbm.
+ */
+
+#define OBJECTS 4
+
+static double now_s(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+  int frames = argc > 1 ? atoi(argv[1]) : 20000;
+  static render_data_t data;
+  data.render_mode = RENDER_FILLED;
+  render_fill_init(&data);
+  static uint8_t fb[LCD_BUF_SIZE];
+  fill_target_t target = {fb, data.coverage, LCD_WIDTH, LCD_HEIGHT};
+
+  object3d_t sphere = {0};
+  object3d_sphere_init(&sphere, SPHERE_LATITUDE_COUNT, SPHERE_LONGITUDE_COUNT);
+  int16_t *xy = malloc(sphere.verts.count * 2 * sizeof(int16_t));
+  if (!xy) return 1;
+
+  // 장치와 같은 카메라와 물체 위치
+  camera_t cam;
+  camera_init(&cam, LCD_WIDTH, LCD_HEIGHT, FOV);
+  camera_set_pos(&cam, (vec3_t){0, 0, -8});
+  camera_look_at(&cam, (vec3_t){0, 0, 0});
+  camera_update(&cam);
+  const float offsets[OBJECTS] = {-4, -4.0f / 3, 4.0f / 3, 4};
+
+  long triangles = 0;
+  double start = now_s();
+  for (int f = 0; f < frames; f++) {
+    memset(fb, 0, sizeof(fb));
+    fill_clear_coverage(&target);
+    for (int o = 0; o < OBJECTS; o++) {
+      float a = f * 0.05f + o;
+      mat3_t r = mat3_from_euler(0, 1, sinf(a), cosf(a), 0, 1);
+      mat34_t world = mat34_from_rt(&r, (vec3_t){offsets[o], 0, 0});
+      mat34_t mvp = mat34_mul(&cam.view_proj, &world);
+      const vertex_soa_t *v = &sphere.verts;
+      xform_project(&mvp, v->x, v->y, v->z, v->count, CAMERA_NEAR, xy);
+      triangles += render_fill_faces(fb, &data, &sphere, xy, &world);
+    }
+  }
+  double elapsed = now_s() - start;
+
+  printf("%d frames, %.1f triangles/frame drawn\n", frames,
+         (double)triangles / frames);
+  printf("%.0f frames/s, %.2f us/frame\n", frames / elapsed,
+         elapsed / frames * 1e6);
+
+  if (argc > 2) {
+    FILE *out = fopen(argv[2], "wb");
+    if (!out) return 1;
+    fprintf(out, "P4\n%d %d\n", LCD_WIDTH, LCD_HEIGHT);
+    fwrite(fb, 1, sizeof(fb), out);
+    fclose(out);
+  }
+  free(xy);
+  object3d_free(&sphere);
+  return 0;
+}
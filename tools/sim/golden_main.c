@@ -0,0 +1,293 @@
+#include <errno.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "raster.h"
+#include "render.h"
+#include "sim.h"
+
+/*
+ * golden frame check. the render task body runs on a fixed timestep and
+ * each frame goes through the same dirty row copy as render_present and
+ * the same page conversion as lvgl_flush_cb, so what gets hashed is the
+ * SSD1306 lcd_buf the panel would receive. goldens are a hash list plus
+ * every frame stacked into one tall PBM for pixel diffs.
+ */
+
+#define GOLDEN_FRAMES 90  // 3 s at FRAME_TARGET_FPS, one sphere lift period
+#define GOLDEN_DIFF_SCALE 2
+#define GOLDEN_DIFF_GAP 4  // lit columns between golden, actual and xor
+
+typedef struct {
+  const char *dir;
+  const char *diff_dir;
+  uint32_t frames;
+  uint32_t tolerance;  // differing pixels allowed per frame
+  bool update;
+} golden_options_t;
+
+static golden_options_t opts = {
+    .dir = "golden",
+    .diff_dir = "golden_diff",
+    .frames = GOLDEN_FRAMES,
+};
+
+static int64_t golden_now;
+
+static int64_t golden_clock(void) { return golden_now; }
+
+static uint64_t fnv1a64(const uint8_t *p, size_t n) {
+  uint64_t h = 0xcbf29ce484222325ULL;
+  while (n--) h = (h ^ *p++) * 0x100000001b3ULL;
+  return h;
+}
+
+// lcd_buf의 page 배치를 행 우선 1bpp로, 비교와 이미지 저장용
+static void pages_to_bits(const uint8_t *pages, uint8_t *bits) {
+  memset(bits, 0, LCD_BUF_SIZE);
+  for (int y = 0; y < LCD_HEIGHT; y++)
+    for (int x = 0; x < LCD_WIDTH; x++)
+      if (pages[LCD_WIDTH * (y >> 3) + x] >> (y % 8) & 1)
+        bits[RASTER_STRIDE * y + x / 8] |= 0x80 >> (x % 8);
+}
+
+static bool bit(const uint8_t *bits, int stride, int x, int y) {
+  return bits[stride * y + x / 8] >> (7 - x % 8) & 1;
+}
+
+static void put(uint8_t *bits, int stride, int x, int y) {
+  bits[stride * y + x / 8] |= 0x80 >> (x % 8);
+}
+
+static uint32_t diff_pixels(const uint8_t *a, const uint8_t *b) {
+  uint32_t n = 0;
+  for (int i = 0; i < LCD_BUF_SIZE; i++) n += __builtin_popcount(a[i] ^ b[i]);
+  return n;
+}
+
+// golden | actual | xor를 나란히 놓은 PNG
+static void write_diff(uint32_t frame, const uint8_t *golden,
+                       const uint8_t *actual) {
+  int width = LCD_WIDTH * 3 + GOLDEN_DIFF_GAP * 2;
+  int stride = (width + 7) / 8;
+  uint8_t *img = calloc(stride, LCD_HEIGHT);
+  if (!img) abort();
+  for (int y = 0; y < LCD_HEIGHT; y++) {
+    for (int x = 0; x < LCD_WIDTH; x++) {
+      bool g = bit(golden, RASTER_STRIDE, x, y);
+      bool a = bit(actual, RASTER_STRIDE, x, y);
+      if (g) put(img, stride, x, y);
+      if (a) put(img, stride, LCD_WIDTH + GOLDEN_DIFF_GAP + x, y);
+      if (g != a) put(img, stride, (LCD_WIDTH + GOLDEN_DIFF_GAP) * 2 + x, y);
+    }
+    for (int i = 0; i < GOLDEN_DIFF_GAP; i++) {
+      put(img, stride, LCD_WIDTH + i, y);
+      put(img, stride, LCD_WIDTH * 2 + GOLDEN_DIFF_GAP + i, y);
+    }
+  }
+  char path[512];
+  snprintf(path, sizeof(path), "%s/frame_%05u.png", opts.diff_dir,
+           (unsigned)frame);
+  if (!sim_write_png(path, img, width, LCD_HEIGHT, GOLDEN_DIFF_SCALE))
+    fprintf(stderr, "failed to write %s: %s\n", path, strerror(errno));
+  free(img);
+}
+
+/* golden files */
+
+static bool read_hashes(uint64_t *hashes, uint32_t count, uint32_t *loaded) {
+  char path[512];
+  snprintf(path, sizeof(path), "%s/frames.txt", opts.dir);
+  FILE *f = fopen(path, "r");
+  if (!f) return false;
+  char line[128];
+  *loaded = 0;
+  while (fgets(line, sizeof(line), f)) {
+    unsigned frame;
+    uint64_t hash;
+    if (line[0] == '#') continue;
+    if (sscanf(line, "%u %" SCNx64, &frame, &hash) != 2 || frame >= count)
+      continue;
+    hashes[frame] = hash;
+    if (frame + 1 > *loaded) *loaded = frame + 1;
+  }
+  fclose(f);
+  return true;
+}
+
+// sim_write_pbm이 쓴 세로로 긴 P4, 1이 꺼진 픽셀
+static bool read_images(uint8_t *bits, uint32_t count, uint32_t *loaded) {
+  char path[512];
+  snprintf(path, sizeof(path), "%s/frames.pbm", opts.dir);
+  FILE *f = fopen(path, "rb");
+  if (!f) return false;
+  int width, height;
+  bool ok = fscanf(f, "P4 %d %d", &width, &height) == 2 &&
+            fgetc(f) != EOF && width == LCD_WIDTH &&
+            height > 0 && height % LCD_HEIGHT == 0;
+  if (ok) {
+    uint32_t frames = height / LCD_HEIGHT;
+    *loaded = frames < count ? frames : count;
+    size_t n = (size_t)*loaded * LCD_BUF_SIZE;
+    ok = fread(bits, 1, n, f) == n;
+    for (size_t i = 0; i < n; i++) bits[i] = ~bits[i];
+  }
+  fclose(f);
+  return ok;
+}
+
+static void write_goldens(const uint64_t *hashes, const uint8_t *bits) {
+  char path[512];
+  snprintf(path, sizeof(path), "%s/frames.txt", opts.dir);
+  FILE *f = fopen(path, "w");
+  if (!f) {
+    fprintf(stderr, "cannot write %s: %s\n", path, strerror(errno));
+    exit(1);
+  }
+  fprintf(f, "# frame, FNV-1a 64 of the SSD1306 lcd_buf\n");
+  fprintf(f, "# %u frames %u us apart, regenerate with make -C tools "
+          "golden-update\n", (unsigned)opts.frames,
+          (unsigned)(1000000 / FRAME_TARGET_FPS));
+  for (uint32_t i = 0; i < opts.frames; i++)
+    fprintf(f, "%u %016" PRIx64 "\n", (unsigned)i, hashes[i]);
+  if (fclose(f) != 0) exit(1);
+
+  snprintf(path, sizeof(path), "%s/frames.pbm", opts.dir);
+  if (!sim_write_pbm(path, bits, LCD_WIDTH, LCD_HEIGHT * opts.frames, 1)) {
+    fprintf(stderr, "cannot write %s: %s\n", path, strerror(errno));
+    exit(1);
+  }
+  printf("wrote %u golden frames to %s\n", (unsigned)opts.frames, opts.dir);
+}
+
+/* render */
+
+// render_present와 lvgl_flush_cb가 하는 일만 남김, 무효 영역은 rounder처럼 page 행으로
+static void present(render_data_t *data, uint8_t *canvas, uint8_t *lcd_buf) {
+  bool fresh;
+  frame_rect_t dirty;
+  const uint8_t *frame = frame_tribuf_acquire(data->frames, &fresh, &dirty);
+  if (!fresh || frame_rect_is_empty(&dirty)) return;
+  uint32_t offset = dirty.y1 * RASTER_STRIDE;
+  memcpy(canvas + offset, frame + offset,
+         (dirty.y2 - dirty.y1 + 1) * RASTER_STRIDE);
+  raster_to_pages(canvas, lcd_buf, 0, dirty.y1 & ~7, LCD_WIDTH - 1,
+                  dirty.y2 | 7);
+}
+
+static void render_all(uint64_t *hashes, uint8_t *bits) {
+  render_data_t *data = setup_render_data(NULL);
+  anim_clock_init(&data->clock, golden_clock);
+  uint32_t period_us = atomic_load(&data->sched->period_us);
+  uint8_t canvas[LCD_BUF_SIZE] = {0};
+  uint8_t lcd_buf[LCD_BUF_SIZE] = {0};
+  for (uint32_t i = 0; i < opts.frames; i++) {
+    golden_now = (int64_t)i * period_us;
+    render_frame(data);
+    present(data, canvas, lcd_buf);
+    hashes[i] = fnv1a64(lcd_buf, LCD_BUF_SIZE);
+    pages_to_bits(lcd_buf, bits + (size_t)i * LCD_BUF_SIZE);
+  }
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "usage: %s [-g dir] [-d dir] [-n frames] [-p pixels] [-u]\n"
+          "  -g dir     golden frames.txt and frames.pbm (golden)\n"
+          "  -d dir     where diff images of failing frames go "
+          "(golden_diff)\n"
+          "  -n frames  frames to render (%d)\n"
+          "  -p pixels  differing pixels tolerated per frame (0)\n"
+          "  -u         rewrite the goldens from this build\n",
+          prog, GOLDEN_FRAMES);
+  exit(2);
+}
+
+int main(int argc, char **argv) {
+  int c;
+  while ((c = getopt(argc, argv, "g:d:n:p:u")) != -1) {
+    switch (c) {
+      case 'g':
+        opts.dir = optarg;
+        break;
+      case 'd':
+        opts.diff_dir = optarg;
+        break;
+      case 'n':
+        opts.frames = atoi(optarg);
+        break;
+      case 'p':
+        opts.tolerance = atoi(optarg);
+        break;
+      case 'u':
+        opts.update = true;
+        break;
+      default:
+        usage(argv[0]);
+    }
+  }
+  if (optind != argc || opts.frames < 1) usage(argv[0]);
+
+  sim_time_init();
+  sim_task_init();
+  uint64_t *hashes = calloc(opts.frames, sizeof(*hashes));
+  uint8_t *bits = calloc(opts.frames, LCD_BUF_SIZE);
+  uint64_t *golden_hashes = calloc(opts.frames, sizeof(*golden_hashes));
+  uint8_t *golden_bits = calloc(opts.frames, LCD_BUF_SIZE);
+  if (!hashes || !bits || !golden_hashes || !golden_bits) abort();
+  render_all(hashes, bits);
+
+  if (opts.update) {
+    write_goldens(hashes, bits);
+    return 0;
+  }
+
+  uint32_t hash_count = 0, image_count = 0;
+  if (!read_hashes(golden_hashes, opts.frames, &hash_count)) {
+    fprintf(stderr, "no goldens in %s, run with -u first\n", opts.dir);
+    return 1;
+  }
+  if (!read_images(golden_bits, opts.frames, &image_count)) image_count = 0;
+  if (hash_count < opts.frames)
+    fprintf(stderr, "goldens cover %u of %u frames\n", (unsigned)hash_count,
+            (unsigned)opts.frames);
+
+  uint32_t exact = 0, tolerated = 0, failed = 0;
+  for (uint32_t i = 0; i < hash_count; i++) {
+    if (hashes[i] == golden_hashes[i]) {
+      exact++;
+      continue;
+    }
+    const uint8_t *actual = bits + (size_t)i * LCD_BUF_SIZE;
+    const uint8_t *golden = golden_bits + (size_t)i * LCD_BUF_SIZE;
+    if (i >= image_count) {
+      printf("frame %u: hash %016" PRIx64 ", golden %016" PRIx64
+             ", no golden image\n", (unsigned)i, hashes[i],
+             golden_hashes[i]);
+      failed++;
+      continue;
+    }
+    uint32_t pixels = diff_pixels(actual, golden);
+    if (pixels <= opts.tolerance) {
+      tolerated++;
+      continue;
+    }
+    if (failed++ == 0 && mkdir(opts.diff_dir, 0755) != 0 && errno != EEXIST)
+      fprintf(stderr, "cannot create %s: %s\n", opts.diff_dir,
+              strerror(errno));
+    printf("frame %u: %u pixels differ, see %s/frame_%05u.png\n",
+           (unsigned)i, (unsigned)pixels, opts.diff_dir, (unsigned)i);
+    write_diff(i, golden, actual);
+  }
+  printf("%u frames: %u exact, %u within %u pixels, %u failed\n",
+         (unsigned)hash_count, (unsigned)exact, (unsigned)tolerated,
+         (unsigned)opts.tolerance, (unsigned)failed);
+  return failed || hash_count < opts.frames ? 1 : 0;
+}
@@ -0,0 +1,37 @@
+#ifndef __SIM_DRIVER_GPIO_H__
+#define __SIM_DRIVER_GPIO_H__
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "hal/gpio_types.h"
+
+typedef enum {
+  GPIO_MODE_DISABLE = 0,
+  GPIO_MODE_INPUT,
+  GPIO_MODE_OUTPUT,
+} gpio_mode_t;
+
+typedef enum {
+  GPIO_PULLUP_DISABLE = 0,
+  GPIO_PULLUP_ENABLE,
+} gpio_pullup_t;
+
+typedef enum {
+  GPIO_PULLDOWN_DISABLE = 0,
+  GPIO_PULLDOWN_ENABLE,
+} gpio_pulldown_t;
+
+typedef struct {
+  uint64_t pin_bit_mask;
+  gpio_mode_t mode;
+  gpio_pullup_t pull_up_en;
+  gpio_pulldown_t pull_down_en;
+  int intr_type;
+} gpio_config_t;
+
+esp_err_t gpio_config(const gpio_config_t *config);
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num);
+int gpio_get_level(gpio_num_t gpio_num);
+
+#endif  // __SIM_DRIVER_GPIO_H__
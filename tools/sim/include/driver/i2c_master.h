@@ -0,0 +1,30 @@
+#ifndef __SIM_I2C_MASTER_H__
+#define __SIM_I2C_MASTER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "hal/gpio_types.h"
+
+typedef enum { I2C_CLK_SRC_DEFAULT } i2c_clock_source_t;
+
+typedef struct {
+  int i2c_port;
+  gpio_num_t sda_io_num;
+  gpio_num_t scl_io_num;
+  i2c_clock_source_t clk_source;
+  uint8_t glitch_ignore_cnt;
+  int intr_priority;
+  size_t trans_queue_depth;
+  struct {
+    uint32_t enable_internal_pullup : 1;
+  } flags;
+} i2c_master_bus_config_t;
+
+typedef struct i2c_master_bus_t *i2c_master_bus_handle_t;
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t *config,
+                             i2c_master_bus_handle_t *ret_bus_handle);
+
+#endif  // __SIM_I2C_MASTER_H__
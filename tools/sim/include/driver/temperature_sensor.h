@@ -0,0 +1,24 @@
+#ifndef __SIM_TEMPERATURE_SENSOR_H__
+#define __SIM_TEMPERATURE_SENSOR_H__
+
+#include "esp_err.h"
+
+typedef enum {
+  TEMPERATURE_SENSOR_CLK_SRC_DEFAULT
+} temperature_sensor_clk_src_t;
+
+typedef struct {
+  int range_min;
+  int range_max;
+  temperature_sensor_clk_src_t clk_src;
+} temperature_sensor_config_t;
+
+typedef struct temperature_sensor_obj_t *temperature_sensor_handle_t;
+
+esp_err_t temperature_sensor_install(const temperature_sensor_config_t *config,
+                                     temperature_sensor_handle_t *ret_sens);
+esp_err_t temperature_sensor_enable(temperature_sensor_handle_t tsens);
+esp_err_t temperature_sensor_get_celsius(temperature_sensor_handle_t tsens,
+                                         float *out_celsius);
+
+#endif  // __SIM_TEMPERATURE_SENSOR_H__
@@ -0,0 +1,19 @@
+#ifndef __SIM_DRIVER_UART_H__
+#define __SIM_DRIVER_UART_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+typedef int uart_port_t;
+
+// the TX ring drains at the console baud rate into sim_options.console
+esp_err_t uart_driver_install(uart_port_t uart_num, int rx_buffer_size,
+                              int tx_buffer_size, int queue_size,
+                              void *uart_queue, int intr_alloc_flags);
+bool uart_is_driver_installed(uart_port_t uart_num);
+esp_err_t uart_get_tx_buffer_free_size(uart_port_t uart_num, size_t *size);
+int uart_write_bytes(uart_port_t uart_num, const void *src, size_t size);
+
+#endif  // __SIM_DRIVER_UART_H__
@@ -0,0 +1,6 @@
+#ifndef __SIM_DRIVER_UART_VFS_H__
+#define __SIM_DRIVER_UART_VFS_H__
+
+void uart_vfs_dev_use_driver(int uart_num);
+
+#endif  // __SIM_DRIVER_UART_VFS_H__
@@ -0,0 +1,7 @@
+#ifndef __SIM_ESP_ATTR_H__
+#define __SIM_ESP_ATTR_H__
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+
+#endif  // __SIM_ESP_ATTR_H__
@@ -0,0 +1,12 @@
+#ifndef __SIM_ESP_CPU_H__
+#define __SIM_ESP_CPU_H__
+
+#include <stdint.h>
+
+typedef uint32_t esp_cpu_cycle_count_t;
+
+// wall clock scaled to CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ, so cycle deltas
+// divided by the configured frequency still give microseconds
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void);
+
+#endif  // __SIM_ESP_CPU_H__
@@ -0,0 +1,31 @@
+#ifndef __SIM_ESP_HEAP_CAPS_H__
+#define __SIM_ESP_HEAP_CAPS_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DMA (1 << 3)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+// pretend heap size, close to what an ESP32-C3 has left after boot
+#define SIM_HEAP_SIZE (300 * 1024)
+
+/*
+ * backed by malloc. usage is counted against SIM_HEAP_SIZE so the memory
+ * figures look like the device's; there is no fragmentation model, the
+ * largest free block is all the free space.
+ */
+void *heap_caps_malloc(size_t size, uint32_t caps);
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps);
+void *heap_caps_realloc(void *ptr, size_t size, uint32_t caps);
+void heap_caps_free(void *ptr);
+size_t heap_caps_get_allocated_size(void *ptr);
+size_t heap_caps_get_total_size(uint32_t caps);
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+size_t heap_caps_get_minimum_free_size(uint32_t caps);
+bool heap_caps_check_integrity(uint32_t caps, bool print_errors);
+
+#endif  // __SIM_ESP_HEAP_CAPS_H__
@@ -0,0 +1,19 @@
+#ifndef __SIM_ESP_LCD_PANEL_DEV_H__
+#define __SIM_ESP_LCD_PANEL_DEV_H__
+
+#include <stdint.h>
+
+#include "hal/gpio_types.h"
+
+typedef struct {
+  int reset_gpio_num;
+  int rgb_ele_order;
+  int data_endian;
+  uint32_t bits_per_pixel;
+  struct {
+    uint32_t reset_active_high : 1;
+  } flags;
+  void *vendor_config;
+} esp_lcd_panel_dev_config_t;
+
+#endif  // __SIM_ESP_LCD_PANEL_DEV_H__
@@ -0,0 +1,35 @@
+#ifndef __SIM_ESP_LCD_PANEL_IO_H__
+#define __SIM_ESP_LCD_PANEL_IO_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "driver/i2c_master.h"
+#include "esp_err.h"
+#include "esp_lcd_types.h"
+
+typedef struct {
+  uint32_t dev_addr;
+  void *on_color_trans_done;
+  void *user_ctx;
+  size_t control_phase_bytes;
+  unsigned int dc_bit_offset;
+  int lcd_cmd_bits;
+  int lcd_param_bits;
+  struct {
+    unsigned int dc_low_on_data : 1;
+    unsigned int disable_control_phase : 1;
+  } flags;
+  uint32_t scl_speed_hz;
+} esp_lcd_panel_io_i2c_config_t;
+
+// the io is the virtual SSD1306 itself (sim_ssd1306.c), nothing goes on a bus
+esp_err_t esp_lcd_new_panel_io_i2c(i2c_master_bus_handle_t bus,
+                                   const esp_lcd_panel_io_i2c_config_t *config,
+                                   esp_lcd_panel_io_handle_t *ret_io);
+esp_err_t esp_lcd_panel_io_tx_param(esp_lcd_panel_io_handle_t io, int lcd_cmd,
+                                    const void *param, size_t param_size);
+esp_err_t esp_lcd_panel_io_tx_color(esp_lcd_panel_io_handle_t io, int lcd_cmd,
+                                    const void *color, size_t color_size);
+
+#endif  // __SIM_ESP_LCD_PANEL_IO_H__
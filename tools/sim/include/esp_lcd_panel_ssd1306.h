@@ -0,0 +1,19 @@
+#ifndef __SIM_ESP_LCD_PANEL_SSD1306_H__
+#define __SIM_ESP_LCD_PANEL_SSD1306_H__
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_lcd_panel_dev.h"
+#include "esp_lcd_types.h"
+
+typedef struct {
+  uint8_t height;
+} esp_lcd_panel_ssd1306_config_t;
+
+// same command sequence as the esp_lcd driver, sent to the io as parameters
+esp_err_t esp_lcd_new_panel_ssd1306(const esp_lcd_panel_io_handle_t io,
+                                    const esp_lcd_panel_dev_config_t *config,
+                                    esp_lcd_panel_handle_t *ret_panel);
+
+#endif  // __SIM_ESP_LCD_PANEL_SSD1306_H__
@@ -0,0 +1,7 @@
+#ifndef __SIM_ESP_LCD_TYPES_H__
+#define __SIM_ESP_LCD_TYPES_H__
+
+typedef struct esp_lcd_panel_io_t *esp_lcd_panel_io_handle_t;
+typedef struct esp_lcd_panel_t *esp_lcd_panel_handle_t;
+
+#endif  // __SIM_ESP_LCD_TYPES_H__
@@ -0,0 +1,25 @@
+#ifndef __SIM_ESP_LOG_H__
+#define __SIM_ESP_LOG_H__
+
+#include "esp_err.h"
+
+// 0 none .. 5 verbose like CONFIG_LOG_DEFAULT_LEVEL, -DSIM_LOG_LEVEL=4 debug
+#ifndef SIM_LOG_LEVEL
+#define SIM_LOG_LEVEL 3
+#endif
+
+void sim_log(char level, const char *tag, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#define SIM_LOG(n, c, tag, fmt, ...)                          \
+  do {                                                        \
+    if (SIM_LOG_LEVEL >= n) sim_log(c, tag, fmt, ##__VA_ARGS__); \
+  } while (0)
+
+#define ESP_LOGE(tag, fmt, ...) SIM_LOG(1, 'E', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) SIM_LOG(2, 'W', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) SIM_LOG(3, 'I', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) SIM_LOG(4, 'D', tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...) SIM_LOG(5, 'V', tag, fmt, ##__VA_ARGS__)
+
+#endif  // __SIM_ESP_LOG_H__
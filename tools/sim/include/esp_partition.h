@@ -0,0 +1,41 @@
+#ifndef __SIM_ESP_PARTITION_H__
+#define __SIM_ESP_PARTITION_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+// a single data partition backed by the file given with sim -v
+typedef enum {
+  ESP_PARTITION_TYPE_APP = 0x00,
+  ESP_PARTITION_TYPE_DATA = 0x01,
+} esp_partition_type_t;
+
+typedef int esp_partition_subtype_t;
+
+typedef enum {
+  ESP_PARTITION_MMAP_DATA,
+  ESP_PARTITION_MMAP_INST,
+} esp_partition_mmap_memory_t;
+
+typedef uint32_t esp_partition_mmap_handle_t;
+
+typedef struct {
+  esp_partition_type_t type;
+  esp_partition_subtype_t subtype;
+  uint32_t address;
+  uint32_t size;
+  char label[17];
+} esp_partition_t;
+
+const esp_partition_t *esp_partition_find_first(
+    esp_partition_type_t type, esp_partition_subtype_t subtype,
+    const char *label);
+esp_err_t esp_partition_mmap(const esp_partition_t *partition, size_t offset,
+                             size_t size, esp_partition_mmap_memory_t memory,
+                             const void **out_ptr,
+                             esp_partition_mmap_handle_t *out_handle);
+void esp_partition_munmap(esp_partition_mmap_handle_t handle);
+
+#endif  // __SIM_ESP_PARTITION_H__
@@ -0,0 +1,9 @@
+#ifndef __SIM_ESP_TIMER_H__
+#define __SIM_ESP_TIMER_H__
+
+#include <stdint.h>
+
+// microseconds since the simulator started
+int64_t esp_timer_get_time(void);
+
+#endif  // __SIM_ESP_TIMER_H__
@@ -0,0 +1,33 @@
+#ifndef __SIM_FREERTOS_H__
+#define __SIM_FREERTOS_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_attr.h"
+#include "sdkconfig.h"
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+
+#define configTICK_RATE_HZ CONFIG_FREERTOS_HZ
+#define configMAX_TASK_NAME_LEN CONFIG_FREERTOS_MAX_TASK_NAME_LEN
+#define configSTACK_DEPTH_TYPE uint32_t
+#define portTICK_PERIOD_MS ((TickType_t)1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms) \
+  ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000U))
+
+// one lock stands in for masking interrupts on the single core
+UBaseType_t sim_interrupt_mask_set(void);
+void sim_interrupt_mask_clear(UBaseType_t state);
+#define portSET_INTERRUPT_MASK_FROM_ISR() sim_interrupt_mask_set()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x) sim_interrupt_mask_clear(x)
+
+#endif  // __SIM_FREERTOS_H__
@@ -0,0 +1,12 @@
+#ifndef __SIM_SEMPHR_H__
+#define __SIM_SEMPHR_H__
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct sim_semaphore_t *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+
+#endif  // __SIM_SEMPHR_H__
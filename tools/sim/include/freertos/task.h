@@ -0,0 +1,55 @@
+#ifndef __SIM_TASK_H__
+#define __SIM_TASK_H__
+
+#include "freertos/FreeRTOS.h"
+
+/*
+ * tasks are pthreads scheduled by the host kernel, priorities are recorded
+ * but not enforced. notifications are counting (ulTaskNotifyTake/Give only).
+ */
+typedef struct tskTaskControlBlock *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+typedef enum {
+  eRunning = 0,
+  eReady,
+  eBlocked,
+  eSuspended,
+  eDeleted,
+  eInvalid
+} eTaskState;
+
+typedef struct {
+  TaskHandle_t xHandle;
+  const char *pcTaskName;
+  UBaseType_t xTaskNumber;
+  eTaskState eCurrentState;
+  UBaseType_t uxCurrentPriority;
+  UBaseType_t uxBasePriority;
+  uint32_t ulRunTimeCounter;  // thread CPU time in microseconds
+  void *pxStackBase;
+  configSTACK_DEPTH_TYPE usStackHighWaterMark;
+  BaseType_t xCoreID;
+} TaskStatus_t;
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name,
+                       configSTACK_DEPTH_TYPE stack_depth, void *arg,
+                       UBaseType_t priority, TaskHandle_t *created);
+void vTaskDelete(TaskHandle_t task);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+TaskHandle_t xTaskGetHandle(const char *name);
+char *pcTaskGetName(TaskHandle_t task);
+TickType_t xTaskGetTickCount(void);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t *prev_wake, TickType_t increment);
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *status, UBaseType_t size,
+                                 uint32_t *total_runtime);
+
+// registers the calling thread as task "main" before app_main runs
+void sim_task_init(void);
+
+#endif  // __SIM_TASK_H__
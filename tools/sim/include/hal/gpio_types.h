@@ -0,0 +1,19 @@
+#ifndef __SIM_GPIO_TYPES_H__
+#define __SIM_GPIO_TYPES_H__
+
+typedef enum {
+  GPIO_NUM_NC = -1,
+  GPIO_NUM_0 = 0,
+  GPIO_NUM_1,
+  GPIO_NUM_2,
+  GPIO_NUM_3,
+  GPIO_NUM_4,
+  GPIO_NUM_5,
+  GPIO_NUM_6,
+  GPIO_NUM_7,
+  GPIO_NUM_8,
+  GPIO_NUM_9,
+  GPIO_NUM_10,
+} gpio_num_t;
+
+#endif  // __SIM_GPIO_TYPES_H__
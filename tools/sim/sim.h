@@ -0,0 +1,41 @@
+#ifndef __SIM_H__
+#define __SIM_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+typedef enum {
+  SIM_DUMP_NONE,
+  SIM_DUMP_PBM,
+  SIM_DUMP_PNG,
+} sim_dump_format_t;
+
+typedef struct {
+  const char *out_dir;
+  sim_dump_format_t format;
+  uint32_t scale;      // output pixels per panel pixel
+  uint32_t every;      // dump every nth refresh that changed the panel
+  uint32_t refreshes;  // exit after this many refreshes, 0 runs forever
+  bool bus_timing;     // sleep as long as the I2C transfer would take
+  const char *console;  // stdout and the console UART go here (a tty)
+  const char *video;    // file standing in for the video partition
+  // exit 1 if a panel write from outside the LVGL task changes a pixel under
+  // a label or while the monitor screen is shown (gray flips)
+  bool check_overlay;
+} sim_options_t;
+
+extern sim_options_t sim_options;
+
+// monotonic time since sim_time_init
+void sim_time_init(void);
+int64_t sim_time_ns(void);
+void sim_sleep_until_ns(int64_t t_ns);
+
+// writes a 1bpp image, set bits are lit pixels
+bool sim_write_pbm(const char *path, const uint8_t *bits, int width,
+                   int height, int scale);
+bool sim_write_png(const char *path, const uint8_t *bits, int width,
+                   int height, int scale);
+
+#endif  // __SIM_H__
@@ -0,0 +1,338 @@
+#include <malloc.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "driver/gpio.h"
+#include "driver/gptimer.h"
+#include "driver/uart.h"
+#include "driver/uart_vfs.h"
+#include "driver/i2c_master.h"
+#include "driver/temperature_sensor.h"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "sim.h"
+
+#define TAG "SIM"
+#define SIM_TEMPERATURE 25.0f
+
+static struct timespec sim_epoch;
+
+void sim_time_init(void) { clock_gettime(CLOCK_MONOTONIC, &sim_epoch); }
+
+int64_t sim_time_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)(ts.tv_sec - sim_epoch.tv_sec) * 1000000000 +
+         (ts.tv_nsec - sim_epoch.tv_nsec);
+}
+
+void sim_sleep_until_ns(int64_t t_ns) {
+  t_ns += sim_epoch.tv_nsec;
+  struct timespec ts = {
+      .tv_sec = sim_epoch.tv_sec + t_ns / 1000000000,
+      .tv_nsec = t_ns % 1000000000,
+  };
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+  }
+}
+
+int64_t esp_timer_get_time(void) { return sim_time_ns() / 1000; }
+
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void) {
+  return (uint64_t)sim_time_ns() * CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ / 1000;
+}
+
+void sim_log(char level, const char *tag, const char *fmt, ...) {
+  char line[256];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(line, sizeof(line), fmt, args);
+  va_end(args);
+  // 태스크 여럿이 동시에 찍어도 한 줄은 한 번에 나가도록
+  fprintf(stdout, "%c (%lld) %s: %s\n", level,
+          (long long)(esp_timer_get_time() / 1000), tag, line);
+}
+
+/* heap */
+
+static _Atomic size_t heap_used;
+static _Atomic size_t heap_peak;
+
+static void heap_account(ssize_t delta) {
+  size_t used = atomic_fetch_add(&heap_used, delta) + delta;
+  size_t peak = atomic_load(&heap_peak);
+  while (used > peak &&
+         !atomic_compare_exchange_weak(&heap_peak, &peak, used)) {
+  }
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps) {
+  void *p = malloc(size);
+  if (p) heap_account(malloc_usable_size(p));
+  return p;
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+  void *p = calloc(n, size);
+  if (p) heap_account(malloc_usable_size(p));
+  return p;
+}
+
+void *heap_caps_realloc(void *ptr, size_t size, uint32_t caps) {
+  size_t old = ptr ? malloc_usable_size(ptr) : 0;
+  void *p = realloc(ptr, size);
+  if (p) heap_account((ssize_t)malloc_usable_size(p) - (ssize_t)old);
+  return p;
+}
+
+void heap_caps_free(void *ptr) {
+  if (!ptr) return;
+  heap_account(-(ssize_t)malloc_usable_size(ptr));
+  free(ptr);
+}
+
+size_t heap_caps_get_allocated_size(void *ptr) {
+  return malloc_usable_size(ptr);
+}
+
+size_t heap_caps_get_total_size(uint32_t caps) { return SIM_HEAP_SIZE; }
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+  size_t used = atomic_load(&heap_used);
+  return used < SIM_HEAP_SIZE ? SIM_HEAP_SIZE - used : 0;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps) {
+  return heap_caps_get_free_size(caps);
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps) {
+  size_t peak = atomic_load(&heap_peak);
+  return peak < SIM_HEAP_SIZE ? SIM_HEAP_SIZE - peak : 0;
+}
+
+bool heap_caps_check_integrity(uint32_t caps, bool print_errors) {
+  return true;
+}
+
+/* peripherals */
+
+struct i2c_master_bus_t {
+  i2c_master_bus_config_t config;
+};
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t *config,
+                             i2c_master_bus_handle_t *ret_bus_handle) {
+  struct i2c_master_bus_t *bus = calloc(1, sizeof(*bus));
+  if (!bus) return ESP_ERR_NO_MEM;
+  bus->config = *config;
+  *ret_bus_handle = bus;
+  return ESP_OK;
+}
+
+// 풀업만 걸린 입력 핀, 점퍼가 없으니 항상 high
+esp_err_t gpio_config(const gpio_config_t *config) { return ESP_OK; }
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num) { return ESP_OK; }
+
+int gpio_get_level(gpio_num_t gpio_num) { return 1; }
+
+// TX 링은 콘솔 보율로 비워지는 것으로 계산만 하고 쓰기는 바로 콘솔로 보냄
+static struct {
+  pthread_mutex_t lock;
+  bool installed;
+  size_t size;
+  size_t fill;
+  int64_t drained_ns;
+} uart = {.lock = PTHREAD_MUTEX_INITIALIZER};
+
+static void uart_drain(void) {
+  int64_t now = sim_time_ns();
+  size_t n = (now - uart.drained_ns) * (CONFIG_ESP_CONSOLE_UART_BAUDRATE / 10) /
+             1000000000;
+  if (n == 0) return;
+  uart.fill = n < uart.fill ? uart.fill - n : 0;
+  uart.drained_ns = now;
+}
+
+esp_err_t uart_driver_install(uart_port_t uart_num, int rx_buffer_size,
+                              int tx_buffer_size, int queue_size,
+                              void *uart_queue, int intr_alloc_flags) {
+  pthread_mutex_lock(&uart.lock);
+  uart.installed = true;
+  uart.size = tx_buffer_size;
+  uart.drained_ns = sim_time_ns();
+  pthread_mutex_unlock(&uart.lock);
+  return ESP_OK;
+}
+
+bool uart_is_driver_installed(uart_port_t uart_num) { return uart.installed; }
+
+void uart_vfs_dev_use_driver(int uart_num) {}
+
+esp_err_t uart_get_tx_buffer_free_size(uart_port_t uart_num, size_t *size) {
+  pthread_mutex_lock(&uart.lock);
+  uart_drain();
+  *size = uart.size - uart.fill;
+  pthread_mutex_unlock(&uart.lock);
+  return ESP_OK;
+}
+
+int uart_write_bytes(uart_port_t uart_num, const void *src, size_t size) {
+  pthread_mutex_lock(&uart.lock);
+  uart_drain();
+  uart.fill += size;
+  pthread_mutex_unlock(&uart.lock);
+  if (sim_options.console) {
+    fwrite(src, 1, size, stdout);
+    fflush(stdout);
+  }
+  return size;
+}
+
+struct temperature_sensor_obj_t {
+  bool enabled;
+};
+
+esp_err_t temperature_sensor_install(const temperature_sensor_config_t *config,
+                                     temperature_sensor_handle_t *ret_sens) {
+  *ret_sens = calloc(1, sizeof(**ret_sens));
+  return *ret_sens ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t temperature_sensor_enable(temperature_sensor_handle_t tsens) {
+  tsens->enabled = true;
+  return ESP_OK;
+}
+
+esp_err_t temperature_sensor_get_celsius(temperature_sensor_handle_t tsens,
+                                         float *out_celsius) {
+  if (!tsens->enabled) return ESP_ERR_INVALID_STATE;
+  *out_celsius = SIM_TEMPERATURE;
+  return ESP_OK;
+}
+
+struct gptimer_t {
+  pthread_t thread;
+  uint32_t resolution_hz;
+  _Atomic uint64_t alarm_count;
+  gptimer_alarm_cb_t on_alarm;
+  void *user_ctx;
+  bool started;
+};
+
+static void *gptimer_thread(void *arg) {
+  struct gptimer_t *t = arg;
+  int64_t next_ns = sim_time_ns();
+  while (true) {
+    uint64_t count = atomic_load(&t->alarm_count);
+    next_ns += count * 1000000000 / t->resolution_hz;
+    sim_sleep_until_ns(next_ns);
+    gptimer_alarm_event_data_t edata = {
+        .count_value = count,
+        .alarm_value = count,
+    };
+    t->on_alarm(t, &edata, t->user_ctx);
+  }
+  return NULL;
+}
+
+esp_err_t gptimer_new_timer(const gptimer_config_t *config,
+                            gptimer_handle_t *ret_timer) {
+  if (config->direction != GPTIMER_COUNT_UP || config->resolution_hz == 0)
+    return ESP_ERR_INVALID_ARG;
+  struct gptimer_t *t = calloc(1, sizeof(*t));
+  if (!t) return ESP_ERR_NO_MEM;
+  t->resolution_hz = config->resolution_hz;
+  *ret_timer = t;
+  return ESP_OK;
+}
+
+esp_err_t gptimer_register_event_callbacks(gptimer_handle_t timer,
+                                           const gptimer_event_callbacks_t *cbs,
+                                           void *user_data) {
+  timer->on_alarm = cbs->on_alarm;
+  timer->user_ctx = user_data;
+  return ESP_OK;
+}
+
+esp_err_t gptimer_set_alarm_action(gptimer_handle_t timer,
+                                   const gptimer_alarm_config_t *config) {
+  if (!config->flags.auto_reload_on_alarm || config->reload_count != 0 ||
+      config->alarm_count == 0) {
+    ESP_LOGE(TAG, "Only auto-reload alarms from 0 are simulated");
+    return ESP_ERR_INVALID_ARG;
+  }
+  atomic_store(&timer->alarm_count, config->alarm_count);
+  return ESP_OK;
+}
+
+esp_err_t gptimer_enable(gptimer_handle_t timer) { return ESP_OK; }
+
+esp_err_t gptimer_start(gptimer_handle_t timer) {
+  if (timer->started || !timer->on_alarm ||
+      atomic_load(&timer->alarm_count) == 0)
+    return ESP_ERR_INVALID_STATE;
+  timer->started = true;
+  return pthread_create(&timer->thread, NULL, gptimer_thread, timer) == 0
+             ? ESP_OK
+             : ESP_FAIL;
+}
+
+/* flash */
+
+static esp_partition_t video_partition;
+static void *video_map;
+
+const esp_partition_t *esp_partition_find_first(
+    esp_partition_type_t type, esp_partition_subtype_t subtype,
+    const char *label) {
+  struct stat st;
+  if (!sim_options.video || type != ESP_PARTITION_TYPE_DATA) return NULL;
+  if (stat(sim_options.video, &st) != 0) {
+    ESP_LOGE(TAG, "Cannot open %s", sim_options.video);
+    return NULL;
+  }
+  video_partition = (esp_partition_t){
+      .type = type,
+      .subtype = subtype,
+      .size = st.st_size,
+  };
+  snprintf(video_partition.label, sizeof(video_partition.label), "%s",
+           label ? label : "video");
+  return &video_partition;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t *partition, size_t offset,
+                             size_t size, esp_partition_mmap_memory_t memory,
+                             const void **out_ptr,
+                             esp_partition_mmap_handle_t *out_handle) {
+  if (partition != &video_partition || video_map ||
+      offset + size > partition->size)
+    return ESP_ERR_INVALID_ARG;
+  FILE *f = fopen(sim_options.video, "rb");
+  if (!f) return ESP_FAIL;
+  void *p = mmap(NULL, partition->size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+  fclose(f);
+  if (p == MAP_FAILED) return ESP_FAIL;
+  video_map = p;
+  *out_ptr = (const uint8_t *)p + offset;
+  *out_handle = 1;
+  return ESP_OK;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t handle) {
+  if (!video_map) return;
+  munmap(video_map, video_partition.size);
+  video_map = NULL;
+}
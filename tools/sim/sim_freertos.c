@@ -0,0 +1,242 @@
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sim.h"
+
+#define TAG "SIM"
+#define SIM_MAX_TASKS 16
+
+struct tskTaskControlBlock {
+  pthread_t thread;
+  clockid_t cpu_clock;
+  char name[configMAX_TASK_NAME_LEN];
+  TaskFunction_t fn;
+  void *arg;
+  configSTACK_DEPTH_TYPE stack_depth;
+  UBaseType_t priority;
+  UBaseType_t number;
+  bool alive;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;  // CLOCK_MONOTONIC
+  uint32_t notify;
+};
+
+struct sim_semaphore_t {
+  pthread_mutex_t mutex;
+};
+
+static pthread_mutex_t tasks_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct tskTaskControlBlock *tasks[SIM_MAX_TASKS];
+static UBaseType_t task_count;
+static __thread struct tskTaskControlBlock *current;
+static pthread_mutex_t interrupt_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int64_t ticks_to_ns(TickType_t ticks) {
+  return (int64_t)ticks * 1000000000 / configTICK_RATE_HZ;
+}
+
+// pthread_cond_timedwait과 pthread_mutex_timedlock이 받는 절대 시각
+static struct timespec deadline(clockid_t clock, TickType_t ticks) {
+  struct timespec ts;
+  clock_gettime(clock, &ts);
+  int64_t ns = ts.tv_nsec + ticks_to_ns(ticks);
+  ts.tv_sec += ns / 1000000000;
+  ts.tv_nsec = ns % 1000000000;
+  return ts;
+}
+
+static struct tskTaskControlBlock *task_alloc(const char *name,
+                                              configSTACK_DEPTH_TYPE depth,
+                                              UBaseType_t priority) {
+  struct tskTaskControlBlock *t = calloc(1, sizeof(*t));
+  if (!t) return NULL;
+  snprintf(t->name, sizeof(t->name), "%s", name);
+  t->stack_depth = depth;
+  t->priority = priority;
+  t->alive = true;
+  pthread_mutex_init(&t->lock, NULL);
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&t->cond, &attr);
+  pthread_condattr_destroy(&attr);
+
+  pthread_mutex_lock(&tasks_lock);
+  if (task_count == SIM_MAX_TASKS) {
+    pthread_mutex_unlock(&tasks_lock);
+    free(t);
+    return NULL;
+  }
+  t->number = task_count + 1;
+  tasks[task_count++] = t;
+  pthread_mutex_unlock(&tasks_lock);
+  return t;
+}
+
+static void *task_entry(void *arg) {
+  struct tskTaskControlBlock *t = arg;
+  current = t;
+  t->fn(t->arg);
+  ESP_LOGE(TAG, "Task %s returned", t->name);
+  abort();
+}
+
+void sim_task_init(void) {
+  struct tskTaskControlBlock *t = task_alloc("main", 0, 1);
+  if (!t) abort();
+  current = t;
+  t->thread = pthread_self();
+  pthread_getcpuclockid(t->thread, &t->cpu_clock);
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name,
+                       configSTACK_DEPTH_TYPE stack_depth, void *arg,
+                       UBaseType_t priority, TaskHandle_t *created) {
+  struct tskTaskControlBlock *t = task_alloc(name, stack_depth, priority);
+  if (!t) return pdFAIL;
+  t->fn = fn;
+  t->arg = arg;
+  // 핸들은 스레드가 돌기 전에 넘겨야 태스크 알림이 유실되지 않음
+  if (created) *created = t;
+  if (pthread_create(&t->thread, NULL, task_entry, t) != 0) return pdFAIL;
+  pthread_getcpuclockid(t->thread, &t->cpu_clock);
+  pthread_detach(t->thread);
+  return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  if (task && task != current) {
+    ESP_LOGE(TAG, "Only self deletion is simulated");
+    abort();
+  }
+  current->alive = false;
+  pthread_exit(NULL);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) { return current; }
+
+TaskHandle_t xTaskGetHandle(const char *name) {
+  TaskHandle_t found = NULL;
+  pthread_mutex_lock(&tasks_lock);
+  for (UBaseType_t i = 0; i < task_count && !found; i++)
+    if (tasks[i]->alive && strcmp(tasks[i]->name, name) == 0)
+      found = tasks[i];
+  pthread_mutex_unlock(&tasks_lock);
+  return found;
+}
+
+char *pcTaskGetName(TaskHandle_t task) {
+  return (task ? task : current)->name;
+}
+
+TickType_t xTaskGetTickCount(void) {
+  return sim_time_ns() * configTICK_RATE_HZ / 1000000000;
+}
+
+void vTaskDelay(TickType_t ticks) {
+  sim_sleep_until_ns(sim_time_ns() + ticks_to_ns(ticks));
+}
+
+void vTaskDelayUntil(TickType_t *prev_wake, TickType_t increment) {
+  *prev_wake += increment;
+  sim_sleep_until_ns(ticks_to_ns(*prev_wake));
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks) {
+  struct tskTaskControlBlock *t = current;
+  struct timespec until = deadline(CLOCK_MONOTONIC, ticks);
+  pthread_mutex_lock(&t->lock);
+  while (t->notify == 0 && ticks != 0) {
+    int err = ticks == portMAX_DELAY
+                  ? pthread_cond_wait(&t->cond, &t->lock)
+                  : pthread_cond_timedwait(&t->cond, &t->lock, &until);
+    if (err == ETIMEDOUT) break;
+  }
+  uint32_t value = t->notify;
+  if (value) t->notify = clear_on_exit ? 0 : value - 1;
+  pthread_mutex_unlock(&t->lock);
+  return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  pthread_mutex_lock(&task->lock);
+  task->notify++;
+  pthread_cond_signal(&task->cond);
+  pthread_mutex_unlock(&task->lock);
+  return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken) {
+  xTaskNotifyGive(task);
+  if (woken) *woken = pdFALSE;
+}
+
+// 호스트 스레드 스택은 충분히 크고 사용량을 알 수 없어 요청한 크기 전체를 보고
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+  return (task ? task : current)->stack_depth;
+}
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *status, UBaseType_t size,
+                                 uint32_t *total_runtime) {
+  UBaseType_t n = 0;
+  pthread_mutex_lock(&tasks_lock);
+  for (UBaseType_t i = 0; i < task_count; i++)
+    if (tasks[i]->alive) n++;
+  if (n > size) {
+    pthread_mutex_unlock(&tasks_lock);
+    return 0;
+  }
+  n = 0;
+  for (UBaseType_t i = 0; i < task_count; i++) {
+    struct tskTaskControlBlock *t = tasks[i];
+    if (!t->alive) continue;
+    struct timespec cpu;
+    clock_gettime(t->cpu_clock, &cpu);
+    status[n++] = (TaskStatus_t){
+        .xHandle = t,
+        .pcTaskName = t->name,
+        .xTaskNumber = t->number,
+        .eCurrentState = t == current ? eRunning : eReady,
+        .uxCurrentPriority = t->priority,
+        .uxBasePriority = t->priority,
+        .ulRunTimeCounter = cpu.tv_sec * 1000000 + cpu.tv_nsec / 1000,
+        .usStackHighWaterMark = t->stack_depth,
+    };
+  }
+  pthread_mutex_unlock(&tasks_lock);
+  if (total_runtime) *total_runtime = sim_time_ns() / 1000;
+  return n;
+}
+
+UBaseType_t sim_interrupt_mask_set(void) {
+  pthread_mutex_lock(&interrupt_lock);
+  return 0;
+}
+
+void sim_interrupt_mask_clear(UBaseType_t state) {
+  pthread_mutex_unlock(&interrupt_lock);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+  struct sim_semaphore_t *sem = calloc(1, sizeof(*sem));
+  if (sem) pthread_mutex_init(&sem->mutex, NULL);
+  return sem;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+  if (ticks == portMAX_DELAY) return pthread_mutex_lock(&sem->mutex) == 0;
+  if (ticks == 0) return pthread_mutex_trylock(&sem->mutex) == 0;
+  struct timespec until = deadline(CLOCK_REALTIME, ticks);
+  return pthread_mutex_timedlock(&sem->mutex, &until) == 0;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+  return pthread_mutex_unlock(&sem->mutex) == 0;
+}
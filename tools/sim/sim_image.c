@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+
+static bool lit(const uint8_t *bits, int width, int x, int y) {
+  return bits[y * ((width + 7) / 8) + x / 8] >> (7 - x % 8) & 1;
+}
+
+// 확대한 한 행을 1bpp로 채움, on이 켜진 픽셀에 쓸 비트 값
+static void scale_row(const uint8_t *bits, int width, int y, int scale,
+                      bool on, uint8_t *out) {
+  int out_width = width * scale;
+  memset(out, 0, (out_width + 7) / 8);
+  for (int x = 0; x < out_width; x++)
+    if (lit(bits, width, x / scale, y) == on)
+      out[x / 8] |= 0x80 >> (x % 8);
+}
+
+// P4: 1이 검정이므로 꺼진 픽셀을 1로
+bool sim_write_pbm(const char *path, const uint8_t *bits, int width,
+                   int height, int scale) {
+  FILE *f = fopen(path, "wb");
+  if (!f) return false;
+  int out_stride = (width * scale + 7) / 8;
+  uint8_t row[out_stride];
+  fprintf(f, "P4\n%d %d\n", width * scale, height * scale);
+  for (int y = 0; y < height * scale; y++) {
+    scale_row(bits, width, y / scale, scale, false, row);
+    fwrite(row, 1, out_stride, f);
+  }
+  return fclose(f) == 0;
+}
+
+static uint32_t crc_table[256];
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *p, size_t n) {
+  if (!crc_table[1]) {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; k++) c = c & 1 ? 0xedb88320 ^ (c >> 1) : c >> 1;
+      crc_table[i] = c;
+    }
+  }
+  crc = ~crc;
+  while (n--) crc = crc_table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+  return ~crc;
+}
+
+static void put_be32(uint8_t *p, uint32_t v) {
+  p[0] = v >> 24;
+  p[1] = v >> 16;
+  p[2] = v >> 8;
+  p[3] = v;
+}
+
+static void write_chunk(FILE *f, const char *type, const uint8_t *data,
+                        uint32_t len) {
+  uint8_t head[8];
+  put_be32(head, len);
+  memcpy(head + 4, type, 4);
+  uint32_t crc = crc32_update(crc32_update(0, head + 4, 4), data, len);
+  uint8_t tail[4];
+  put_be32(tail, crc);
+  fwrite(head, 1, 8, f);
+  if (len) fwrite(data, 1, len, f);
+  fwrite(tail, 1, 4, f);
+}
+
+/*
+ * 1-bit grayscale PNG. the image data goes in stored (uncompressed) deflate
+ * blocks, a 128x64 frame is small enough that pulling in zlib is not worth
+ * it.
+ */
+bool sim_write_png(const char *path, const uint8_t *bits, int width,
+                   int height, int scale) {
+  static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n',
+                                       0x1a, '\n'};
+  int out_w = width * scale, out_h = height * scale;
+  int row_len = 1 + (out_w + 7) / 8;  // filter byte + pixels
+  size_t raw_len = (size_t)row_len * out_h;
+  size_t blocks = (raw_len + 0xffff - 1) / 0xffff;
+  size_t zlen = 2 + blocks * 5 + raw_len + 4;
+  uint8_t *raw = malloc(raw_len);
+  uint8_t *z = malloc(zlen);
+  if (!raw || !z) {
+    free(raw);
+    free(z);
+    return false;
+  }
+
+  for (int y = 0; y < out_h; y++) {
+    raw[y * row_len] = 0;  // filter: none
+    scale_row(bits, width, y / scale, scale, true, raw + y * row_len + 1);
+  }
+
+  uint8_t *p = z;
+  *p++ = 0x78;  // deflate, 32K window
+  *p++ = 0x01;
+  uint32_t a = 1, b = 0;
+  for (size_t off = 0; off < raw_len; off += 0xffff) {
+    uint16_t n = raw_len - off < 0xffff ? raw_len - off : 0xffff;
+    *p++ = off + n == raw_len;  // BFINAL, BTYPE 00
+    *p++ = n;
+    *p++ = n >> 8;
+    *p++ = ~n;
+    *p++ = ~n >> 8;
+    memcpy(p, raw + off, n);
+    p += n;
+  }
+  for (size_t i = 0; i < raw_len; i++) {
+    a = (a + raw[i]) % 65521;
+    b = (b + a) % 65521;
+  }
+  put_be32(p, b << 16 | a);
+
+  uint8_t ihdr[13];
+  put_be32(ihdr, out_w);
+  put_be32(ihdr + 4, out_h);
+  ihdr[8] = 1;   // bit depth
+  ihdr[9] = 0;   // grayscale
+  ihdr[10] = 0;  // deflate
+  ihdr[11] = 0;  // adaptive filtering
+  ihdr[12] = 0;  // no interlace
+
+  FILE *f = fopen(path, "wb");
+  bool ok = f != NULL;
+  if (ok) {
+    fwrite(signature, 1, sizeof(signature), f);
+    write_chunk(f, "IHDR", ihdr, sizeof(ihdr));
+    write_chunk(f, "IDAT", z, zlen);
+    write_chunk(f, "IEND", NULL, 0);
+    ok = fclose(f) == 0;
+  }
+  free(raw);
+  free(z);
+  return ok;
+}
@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sim.h"
+
+void app_main(void);
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "usage: %s [-o dir] [-f pbm|png|none] [-s scale] [-e every]\n"
+          "          [-n refreshes] [-t] [-c tty] [-v video] [-l]\n"
+          "  -o dir        where frame_NNNNN.* are written (frames)\n"
+          "  -f format     dump format, none only runs the pipeline (png)\n"
+          "  -s scale      output pixels per panel pixel (1)\n"
+          "  -e every      dump every nth refresh that changed the panel (1)\n"
+          "  -n refreshes  exit after this many LVGL refreshes, 0 = never "
+          "(300)\n"
+          "  -t            sleep for the I2C transfer time of each write\n"
+          "  -c tty        console output, logs and the frame stream\n"
+          "  -v video      file to use as the video partition\n"
+          "  -l            fail if a write outside LVGL refreshes changes a "
+          "label\n",
+          prog);
+  exit(2);
+}
+
+// app_main 그대로 실행, 남은 태스크는 스레드로 돌고 종료는 가상 패널이 결정
+int main(int argc, char **argv) {
+  int opt;
+  while ((opt = getopt(argc, argv, "o:f:s:e:n:tc:v:l")) != -1) {
+    switch (opt) {
+      case 'o':
+        sim_options.out_dir = optarg;
+        break;
+      case 'f':
+        if (strcmp(optarg, "pbm") == 0)
+          sim_options.format = SIM_DUMP_PBM;
+        else if (strcmp(optarg, "png") == 0)
+          sim_options.format = SIM_DUMP_PNG;
+        else if (strcmp(optarg, "none") == 0)
+          sim_options.format = SIM_DUMP_NONE;
+        else
+          usage(argv[0]);
+        break;
+      case 's':
+        sim_options.scale = atoi(optarg);
+        break;
+      case 'e':
+        sim_options.every = atoi(optarg);
+        break;
+      case 'n':
+        sim_options.refreshes = atoi(optarg);
+        break;
+      case 't':
+        sim_options.bus_timing = true;
+        break;
+      case 'c':
+        sim_options.console = optarg;
+        break;
+      case 'v':
+        sim_options.video = optarg;
+        break;
+      case 'l':
+        sim_options.check_overlay = true;
+        break;
+      default:
+        usage(argv[0]);
+    }
+  }
+  if (optind != argc || sim_options.scale < 1 || sim_options.every < 1)
+    usage(argv[0]);
+
+  if (sim_options.console && !freopen(sim_options.console, "w", stdout)) {
+    perror(sim_options.console);
+    return 1;
+  }
+  setvbuf(stdout, NULL, _IOLBF, 0);
+  sim_time_init();
+  sim_task_init();
+  app_main();  // vTaskDelete(NULL)로 끝나므로 돌아오지 않음
+  return 0;
+}
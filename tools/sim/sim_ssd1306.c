@@ -0,0 +1,382 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_lcd_panel_ssd1306.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lcd.h"
+#include "lvgl.h"
+#include "sim.h"
+
+#define TAG "SSD1306"
+#define SSD1306_COLUMNS 128
+#define SSD1306_PAGES 8
+
+// 데이터시트의 명령 중 esp_lcd 드라이버가 쓰는 것만
+#define CMD_SET_MEMORY_ADDR_MODE 0x20
+#define CMD_SET_COLUMN_RANGE 0x21
+#define CMD_SET_PAGE_RANGE 0x22
+#define CMD_SET_CONTRAST 0x81
+#define CMD_SET_CHARGE_PUMP 0x8D
+#define CMD_MIRROR_X_OFF 0xA0
+#define CMD_MIRROR_X_ON 0xA1
+#define CMD_INVERT_OFF 0xA6
+#define CMD_INVERT_ON 0xA7
+#define CMD_SET_MULTIPLEX 0xA8
+#define CMD_DISP_OFF 0xAE
+#define CMD_DISP_ON 0xAF
+#define CMD_MIRROR_Y_OFF 0xC0
+#define CMD_MIRROR_Y_ON 0xC8
+#define CMD_SET_COM_PINS 0xDA
+
+// sim_main.c가 명령행으로 바꾸고 wireframe_bench는 기본값 그대로 씀
+sim_options_t sim_options = {
+    .out_dir = "frames",
+    .format = SIM_DUMP_PNG,
+    .scale = 1,
+    .every = 1,
+    .refreshes = 300,
+};
+
+typedef enum {
+  ADDR_HORIZONTAL = 0,
+  ADDR_VERTICAL = 1,
+  ADDR_PAGE = 2,
+} addr_mode_t;
+
+/*
+ * the controller as seen over I2C: GDDRAM is 8 pages of 128 column bytes,
+ * bit n of a byte is row 8 * page + n. data writes go to the current
+ * column/page and advance inside the window set by 0x21/0x22.
+ */
+struct esp_lcd_panel_io_t {
+  uint8_t gddram[SSD1306_PAGES][SSD1306_COLUMNS];
+  addr_mode_t addr_mode;
+  uint8_t col_start, col_end, col;
+  uint8_t page_start, page_end, page;
+  uint8_t height;
+  bool seg_remap;
+  bool com_remap;
+  bool inverted;
+  bool on;
+  uint32_t scl_speed_hz;
+  uint64_t bytes;   // data bytes received
+  uint32_t writes;  // data transfers since the last refresh
+  uint32_t refreshes;
+  uint32_t dumped;
+  bool hooked;  // LV_EVENT_REFR_READY registered
+  TaskHandle_t lvgl_task;  // the one that hooked it
+  // -l: what LVGL drew over the canvas at the last flush
+  lv_area_t overlay[2];
+  int overlay_count;
+  uint32_t foreign_writes;   // draw_bitmap calls from other tasks
+  uint32_t overlay_changed;  // overlay pixels those calls changed
+  bool labels_moved;
+};
+
+struct esp_lcd_panel_t {
+  esp_lcd_panel_io_handle_t io;
+  uint8_t height;
+};
+
+esp_err_t esp_lcd_new_panel_io_i2c(i2c_master_bus_handle_t bus,
+                                   const esp_lcd_panel_io_i2c_config_t *config,
+                                   esp_lcd_panel_io_handle_t *ret_io) {
+  struct esp_lcd_panel_io_t *dev = calloc(1, sizeof(*dev));
+  if (!dev) return ESP_ERR_NO_MEM;
+  // 전원을 켠 직후 상태
+  dev->addr_mode = ADDR_PAGE;
+  dev->col_end = SSD1306_COLUMNS - 1;
+  dev->page_end = SSD1306_PAGES - 1;
+  dev->height = SSD1306_PAGES * 8;
+  dev->scl_speed_hz = config->scl_speed_hz;
+  *ret_io = dev;
+  return ESP_OK;
+}
+
+// 버스에 실리는 비트 수: 주소 + 컨트롤 + 데이터, 바이트마다 ACK 포함 9비트
+static void bus_delay(esp_lcd_panel_io_handle_t dev, size_t bytes) {
+  if (!sim_options.bus_timing || dev->scl_speed_hz == 0) return;
+  int64_t ns = (int64_t)(bytes + 2) * 9 * 1000000000 / dev->scl_speed_hz;
+  sim_sleep_until_ns(sim_time_ns() + ns);
+}
+
+esp_err_t esp_lcd_panel_io_tx_param(esp_lcd_panel_io_handle_t dev, int cmd,
+                                    const void *param, size_t param_size) {
+  const uint8_t *p = param;
+  bus_delay(dev, 1 + param_size);
+  switch (cmd) {
+    case CMD_SET_MEMORY_ADDR_MODE:
+      if (param_size < 1) return ESP_ERR_INVALID_ARG;
+      dev->addr_mode = p[0] & 3;
+      break;
+    case CMD_SET_COLUMN_RANGE:
+      if (param_size < 2) return ESP_ERR_INVALID_ARG;
+      dev->col_start = dev->col = p[0] & 0x7f;
+      dev->col_end = p[1] & 0x7f;
+      break;
+    case CMD_SET_PAGE_RANGE:
+      if (param_size < 2) return ESP_ERR_INVALID_ARG;
+      dev->page_start = dev->page = p[0] & 7;
+      dev->page_end = p[1] & 7;
+      break;
+    case CMD_SET_MULTIPLEX:
+      if (param_size < 1) return ESP_ERR_INVALID_ARG;
+      dev->height = (p[0] & 0x3f) + 1;
+      break;
+    case CMD_MIRROR_X_OFF:
+    case CMD_MIRROR_X_ON:
+      dev->seg_remap = cmd == CMD_MIRROR_X_ON;
+      break;
+    case CMD_MIRROR_Y_OFF:
+    case CMD_MIRROR_Y_ON:
+      dev->com_remap = cmd == CMD_MIRROR_Y_ON;
+      break;
+    case CMD_INVERT_OFF:
+    case CMD_INVERT_ON:
+      dev->inverted = cmd == CMD_INVERT_ON;
+      break;
+    case CMD_DISP_OFF:
+    case CMD_DISP_ON:
+      dev->on = cmd == CMD_DISP_ON;
+      break;
+    case CMD_SET_CONTRAST:
+    case CMD_SET_CHARGE_PUMP:
+    case CMD_SET_COM_PINS:
+      break;  // 이미지에는 영향 없음
+    default:
+      ESP_LOGW(TAG, "Unhandled command 0x%02x", cmd);
+      break;
+  }
+  return ESP_OK;
+}
+
+static void advance(esp_lcd_panel_io_handle_t dev) {
+  switch (dev->addr_mode) {
+    case ADDR_HORIZONTAL:
+      if (dev->col++ < dev->col_end) break;
+      dev->col = dev->col_start;
+      dev->page = dev->page < dev->page_end ? dev->page + 1 : dev->page_start;
+      break;
+    case ADDR_VERTICAL:
+      if (dev->page++ < dev->page_end) break;
+      dev->page = dev->page_start;
+      dev->col = dev->col < dev->col_end ? dev->col + 1 : dev->col_start;
+      break;
+    default:  // page 모드는 열만 증가하고 page 끝에서 되돌아감
+      dev->col = (dev->col + 1) % SSD1306_COLUMNS;
+      break;
+  }
+}
+
+esp_err_t esp_lcd_panel_io_tx_color(esp_lcd_panel_io_handle_t dev, int cmd,
+                                    const void *color, size_t color_size) {
+  const uint8_t *data = color;
+  bus_delay(dev, color_size);
+  for (size_t i = 0; i < color_size; i++) {
+    dev->gddram[dev->page][dev->col] = data[i];
+    advance(dev);
+  }
+  dev->bytes += color_size;
+  dev->writes++;
+  return ESP_OK;
+}
+
+/*
+ * visible image, one bit per pixel MSB first. the common 128x64 modules
+ * wire SEG0 to the right edge and COM0 to the bottom row, which is why
+ * lcd_setup turns both remaps on.
+ */
+static void dev_snapshot(esp_lcd_panel_io_handle_t dev, uint8_t *bits) {
+  int stride = SSD1306_COLUMNS / 8;
+  memset(bits, 0, stride * dev->height);
+  for (int y = 0; y < dev->height; y++) {
+    int row = dev->com_remap ? y : dev->height - 1 - y;
+    for (int x = 0; x < SSD1306_COLUMNS; x++) {
+      int col = dev->seg_remap ? x : SSD1306_COLUMNS - 1 - x;
+      bool lit = dev->gddram[row / 8][col] >> (row % 8) & 1;
+      lit = dev->on && lit != dev->inverted;
+      if (lit) bits[y * stride + x / 8] |= 0x80 >> (x % 8);
+    }
+  }
+}
+
+static void dev_dump(esp_lcd_panel_io_handle_t dev) {
+  static const char *const ext[] = {"", "pbm", "png"};
+  uint8_t bits[SSD1306_COLUMNS / 8 * SSD1306_PAGES * 8];
+  char path[512];
+
+  dev_snapshot(dev, bits);
+  snprintf(path, sizeof(path), "%s/frame_%05u.%s", sim_options.out_dir,
+           (unsigned)dev->refreshes, ext[sim_options.format]);
+  bool ok = sim_options.format == SIM_DUMP_PNG
+                ? sim_write_png(path, bits, SSD1306_COLUMNS, dev->height,
+                                sim_options.scale)
+                : sim_write_pbm(path, bits, SSD1306_COLUMNS, dev->height,
+                                sim_options.scale);
+  if (!ok) {
+    ESP_LOGE(TAG, "Failed to write %s: %s", path, strerror(errno));
+    exit(1);
+  }
+  dev->dumped++;
+}
+
+// lcd.c가 gray_flushed에 넘기는 영역을 LVGL에서 따로 읽음
+static void overlay_update(esp_lcd_panel_io_handle_t dev) {
+  lv_display_t *disp = lv_display_get_default();
+  ssd1306_lcd_panel_t *lcd = lv_display_get_user_data(disp);
+  dev->overlay_count = 0;
+  if (lv_display_get_screen_active(disp) != lcd->main_screen) {
+    dev->overlay[dev->overlay_count++] =
+        (lv_area_t){0, 0, SSD1306_COLUMNS - 1, SSD1306_PAGES * 8 - 1};
+    return;
+  }
+  lv_obj_t *labels[] = {lcd->stat_label, lcd->prof_label};
+  for (int i = 0; i < 2; i++)
+    if (labels[i])
+      lv_obj_get_coords(labels[i], &dev->overlay[dev->overlay_count++]);
+}
+
+static uint32_t overlay_changes(esp_lcd_panel_io_handle_t dev,
+                                const uint8_t (*before)[SSD1306_COLUMNS]) {
+  uint32_t changed = 0;
+  for (int i = 0; i < dev->overlay_count; i++) {
+    const lv_area_t *a = &dev->overlay[i];
+    for (int y = a->y1 > 0 ? a->y1 : 0; y <= a->y2 && y < dev->height; y++)
+      for (int x = a->x1 > 0 ? a->x1 : 0;
+           x <= a->x2 && x < SSD1306_COLUMNS; x++)
+        changed += (before[y / 8][x] ^ dev->gddram[y / 8][x]) >> (y % 8) & 1;
+  }
+  return changed;
+}
+
+// lv_refr_now가 끝날 때마다 불림, 한 번의 갱신에서 나온 flush가 모두 반영된 상태
+static void refr_ready_cb(lv_event_t *e) {
+  esp_lcd_panel_io_handle_t dev = lv_event_get_user_data(e);
+  dev->refreshes++;
+  // 기본 위치의 라벨 아래로는 물체가 지나가지 않음, 물체 위로 옮겨 검사
+  if (sim_options.check_overlay && !dev->labels_moved) {
+    ssd1306_lcd_panel_t *lcd =
+        lv_display_get_user_data(lv_display_get_default());
+    lv_obj_align(lcd->stat_label, LV_ALIGN_LEFT_MID, 2, 0);
+    if (lcd->prof_label)
+      lv_obj_align(lcd->prof_label, LV_ALIGN_RIGHT_MID, -2, 0);
+    dev->labels_moved = true;
+  }
+  if (dev->writes > 0 && sim_options.format != SIM_DUMP_NONE &&
+      dev->refreshes % sim_options.every == 0)
+    dev_dump(dev);
+  dev->writes = 0;
+  if (sim_options.refreshes && dev->refreshes >= sim_options.refreshes) {
+    ESP_LOGI(TAG,
+             "%u refreshes, %u frames written, %llu bytes to the panel",
+             (unsigned)dev->refreshes, (unsigned)dev->dumped,
+             (unsigned long long)dev->bytes);
+    if (sim_options.check_overlay)
+      ESP_LOGI(TAG, "%u writes outside LVGL, %u label pixels changed",
+               (unsigned)dev->foreign_writes,
+               (unsigned)dev->overlay_changed);
+    fflush(stdout);
+    exit(dev->overlay_changed ? 1 : 0);
+  }
+}
+
+esp_err_t esp_lcd_new_panel_ssd1306(const esp_lcd_panel_io_handle_t io,
+                                    const esp_lcd_panel_dev_config_t *config,
+                                    esp_lcd_panel_handle_t *ret_panel) {
+  const esp_lcd_panel_ssd1306_config_t *vendor = config->vendor_config;
+  struct esp_lcd_panel_t *panel = calloc(1, sizeof(*panel));
+  if (!panel) return ESP_ERR_NO_MEM;
+  panel->io = io;
+  panel->height = vendor ? vendor->height : 64;
+  if (sim_options.format != SIM_DUMP_NONE &&
+      mkdir(sim_options.out_dir, 0755) != 0 && errno != EEXIST) {
+    ESP_LOGE(TAG, "Cannot create %s: %s", sim_options.out_dir,
+             strerror(errno));
+    free(panel);
+    return ESP_FAIL;
+  }
+  *ret_panel = panel;
+  return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_reset(esp_lcd_panel_handle_t panel) { return ESP_OK; }
+
+esp_err_t esp_lcd_panel_init(esp_lcd_panel_handle_t panel) {
+  esp_lcd_panel_io_handle_t io = panel->io;
+  ESP_ERROR_CHECK(esp_lcd_panel_io_tx_param(io, CMD_DISP_OFF, NULL, 0));
+  ESP_ERROR_CHECK(esp_lcd_panel_io_tx_param(io, CMD_SET_MULTIPLEX,
+                                            (uint8_t[]){panel->height - 1}, 1));
+  ESP_ERROR_CHECK(esp_lcd_panel_io_tx_param(
+      io, CMD_SET_COM_PINS, (uint8_t[]){panel->height == 64 ? 0x12 : 0x02},
+      1));
+  ESP_ERROR_CHECK(esp_lcd_panel_io_tx_param(io, CMD_SET_MEMORY_ADDR_MODE,
+                                            (uint8_t[]){ADDR_HORIZONTAL}, 1));
+  ESP_ERROR_CHECK(esp_lcd_panel_io_tx_param(io, CMD_SET_CHARGE_PUMP,
+                                            (uint8_t[]){0x14}, 1));
+  ESP_ERROR_CHECK(esp_lcd_panel_io_tx_param(io, CMD_MIRROR_X_OFF, NULL, 0));
+  ESP_ERROR_CHECK(esp_lcd_panel_io_tx_param(io, CMD_MIRROR_Y_OFF, NULL, 0));
+  return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_draw_bitmap(esp_lcd_panel_handle_t panel, int x_start,
+                                    int y_start, int x_end, int y_end,
+                                    const void *color_data) {
+  esp_lcd_panel_io_handle_t io = panel->io;
+  if (x_start >= x_end || y_start >= y_end) return ESP_ERR_INVALID_ARG;
+  // lv_timer_handler_task에서 처음 불릴 때 갱신 완료 이벤트를 등록
+  if (!io->hooked) {
+    lv_display_add_event_cb(lv_display_get_default(), refr_ready_cb,
+                            LV_EVENT_REFR_READY, io);
+    io->hooked = true;
+    io->lvgl_task = xTaskGetCurrentTaskHandle();
+  }
+  uint8_t page_start = y_start / 8;
+  uint8_t page_end = (y_end - 1) / 8;
+  size_t len = (y_end - y_start) * (x_end - x_start) / 8;
+  ESP_ERROR_CHECK(esp_lcd_panel_io_tx_param(
+      io, CMD_SET_COLUMN_RANGE, (uint8_t[]){x_start, x_end - 1}, 2));
+  ESP_ERROR_CHECK(esp_lcd_panel_io_tx_param(
+      io, CMD_SET_PAGE_RANGE, (uint8_t[]){page_start, page_end}, 2));
+  if (!sim_options.check_overlay)
+    return esp_lcd_panel_io_tx_color(io, -1, color_data, len);
+
+  // LVGL flush는 라벨을 바꿀 수 있음, 그 밖의 쓰기(gray flip)는 안 됨
+  bool from_lvgl = xTaskGetCurrentTaskHandle() == io->lvgl_task;
+  if (from_lvgl) overlay_update(io);
+  uint8_t before[SSD1306_PAGES][SSD1306_COLUMNS];
+  memcpy(before, io->gddram, sizeof(before));
+  esp_err_t err = esp_lcd_panel_io_tx_color(io, -1, color_data, len);
+  if (!from_lvgl) {
+    io->foreign_writes++;
+    io->overlay_changed += overlay_changes(io, before);
+  }
+  return err;
+}
+
+esp_err_t esp_lcd_panel_mirror(esp_lcd_panel_handle_t panel, bool mirror_x,
+                               bool mirror_y) {
+  esp_lcd_panel_io_handle_t io = panel->io;
+  ESP_ERROR_CHECK(esp_lcd_panel_io_tx_param(
+      io, mirror_x ? CMD_MIRROR_X_ON : CMD_MIRROR_X_OFF, NULL, 0));
+  return esp_lcd_panel_io_tx_param(
+      io, mirror_y ? CMD_MIRROR_Y_ON : CMD_MIRROR_Y_OFF, NULL, 0);
+}
+
+esp_err_t esp_lcd_panel_invert_color(esp_lcd_panel_handle_t panel,
+                                     bool invert_color_data) {
+  return esp_lcd_panel_io_tx_param(
+      panel->io, invert_color_data ? CMD_INVERT_ON : CMD_INVERT_OFF, NULL, 0);
+}
+
+esp_err_t esp_lcd_panel_disp_on_off(esp_lcd_panel_handle_t panel,
+                                    bool on_off) {
+  return esp_lcd_panel_io_tx_param(
+      panel->io, on_off ? CMD_DISP_ON : CMD_DISP_OFF, NULL, 0);
+}
@@ -0,0 +1,226 @@
+#!/usr/bin/env python3
+"""rebuild the mirrored panel frames from a 'stream,' console stream.
+
+    tools/stream_view.py /dev/ttyUSB0 --ascii   # STREAM_ENABLED in stream.h
+    tools/stream_view.py monitor.log -o frames   # from a captured log
+    tools/stream_view.py --loopback -- sim/ssd1306_sim -f none -c {tty}
+
+every line is 'stream,<seq>,<k|d>,<fnv1a32 of the frame>,<base64 packbits>'.
+a key frame carries the page buffer, a delta the XOR against the previous
+line. a gap in seq or a hash mismatch drops everything up to the next key
+frame. --loopback runs a command with {tty} replaced by a pty and reads
+the other end, which is how the decoder is checked against the simulator.
+"""
+import argparse
+import base64
+import os
+import pty
+import re
+import select
+import struct
+import subprocess
+import sys
+import termios
+import tty
+import zlib
+
+WIDTH, HEIGHT = 128, 64
+PAGE_BYTES = WIDTH * HEIGHT // 8
+LINE = re.compile(r"stream,(\d+),([kd]),([0-9a-f]{8}),([A-Za-z0-9+/=]*)")
+
+
+def unpack(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        n = data[i]
+        if n < 128:
+            out += data[i + 1:i + 2 + n]
+            i += 2 + n
+        else:
+            out += bytes([data[i + 1]]) * (n - 125)
+            i += 2
+    return bytes(out)
+
+
+def fnv1a32(data):
+    h = 2166136261
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xffffffff
+    return h
+
+
+def lit(pages, x, y):
+    return pages[WIDTH * (y >> 3) + x] >> (y & 7) & 1
+
+
+def write_png(path, pages, scale):
+    rows = []
+    for y in range(HEIGHT * scale):
+        bits = [lit(pages, x // scale, y // scale)
+                for x in range(WIDTH * scale)]
+        row = bytearray(1)  # filter: none
+        for x in range(0, len(bits), 8):
+            byte = 0
+            for b in bits[x:x + 8]:
+                byte = byte << 1 | b
+            row.append(byte << (8 - len(bits[x:x + 8])))
+        rows.append(bytes(row))
+
+    def chunk(kind, data):
+        body = kind + data
+        return (struct.pack(">I", len(data)) + body +
+                struct.pack(">I", zlib.crc32(body)))
+
+    ihdr = struct.pack(">IIBBBBB", WIDTH * scale, HEIGHT * scale, 1, 0, 0, 0,
+                       0)
+    with open(path, "wb") as f:
+        f.write(b"\x89PNG\r\n\x1a\n" + chunk(b"IHDR", ihdr) +
+                chunk(b"IDAT", zlib.compress(b"".join(rows))) +
+                chunk(b"IEND", b""))
+
+
+def ascii_frame(pages):
+    # 한 글자에 두 행, 터미널 글자가 대략 1:2 비율이라 원래 모양에 가까움
+    glyphs = " ▀▄█"
+    lines = []
+    for y in range(0, HEIGHT, 2):
+        lines.append("".join(
+            glyphs[lit(pages, x, y) | lit(pages, x, y + 1) << 1]
+            for x in range(WIDTH)))
+    return "\n".join(lines)
+
+
+class Decoder:
+    def __init__(self):
+        self.frame = None  # None until a key frame arrives
+        self.seq = None
+        self.frames = self.keys = self.gaps = self.bad = 0
+
+    def feed(self, line):
+        """returns the rebuilt page buffer, or None if the line gave none"""
+        m = LINE.search(line)
+        if not m:
+            return None
+        seq, kind, want = int(m.group(1)), m.group(2), int(m.group(3), 16)
+        try:
+            delta = unpack(base64.b64decode(m.group(4), validate=True))
+        except (ValueError, IndexError):
+            delta = b""
+        if len(delta) != PAGE_BYTES:
+            self.bad += 1
+            self.frame = None
+            return None
+        if kind == "k":
+            frame = delta
+            self.keys += 1
+        elif self.frame is None:
+            return None
+        elif seq != (self.seq + 1) & 0xffff:
+            self.gaps += 1
+            self.frame = None
+            return None
+        else:
+            frame = bytes(a ^ b for a, b in zip(self.frame, delta))
+        self.seq = seq
+        if fnv1a32(frame) != want:
+            self.bad += 1
+            self.frame = None
+            return None
+        self.frame = frame
+        self.frames += 1
+        return frame
+
+
+def open_serial(path, baud):
+    fd = os.open(path, os.O_RDONLY | os.O_NOCTTY)
+    if os.isatty(fd):
+        tty.setraw(fd)
+        speed = getattr(termios, "B%d" % baud, None)
+        if speed is not None:
+            attrs = termios.tcgetattr(fd)
+            attrs[4] = attrs[5] = speed
+            termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return os.fdopen(fd, "rb", buffering=0)
+
+
+def read_lines(f, proc=None):
+    buf = b""
+    while True:
+        # loopback은 slave를 계속 열어 두므로 EOF 대신 명령이 끝났는지로 판단
+        if proc and not select.select([f], [], [], 0.2)[0]:
+            if proc.poll() is not None:
+                break
+            continue
+        data = f.read(4096)
+        if not data:
+            break
+        buf += data
+        *lines, buf = buf.split(b"\n")
+        for line in lines:
+            yield line.decode("ascii", "replace").rstrip("\r")
+    if buf:
+        yield buf.decode("ascii", "replace")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("source", nargs="?",
+                        help="serial port, pty or log file (stdin)")
+    parser.add_argument("-b", "--baud", type=int, default=115200)
+    parser.add_argument("-o", "--out", help="write frame_NNNNN.png here")
+    parser.add_argument("-s", "--scale", type=int, default=1)
+    parser.add_argument("-n", "--frames", type=int, default=0,
+                        help="stop after this many frames")
+    parser.add_argument("--ascii", action="store_true",
+                        help="redraw the latest frame in the terminal")
+    parser.add_argument("--loopback", action="store_true",
+                        help="run the command after -- on a pty")
+    argv, cmd = sys.argv[1:], []
+    if "--" in argv:
+        cmd = argv[argv.index("--") + 1:]
+        argv = argv[:argv.index("--")]
+    args = parser.parse_args(argv)
+
+    proc = None
+    if args.loopback:
+        if not cmd:
+            parser.error("--loopback needs a command")
+        master, slave = pty.openpty()
+        tty.setraw(slave)  # 줄바꿈 변환 없이
+        name = os.ttyname(slave)
+        proc = subprocess.Popen([a.replace("{tty}", name) for a in cmd])
+        src = os.fdopen(master, "rb", buffering=0)
+    elif args.source:
+        src = open_serial(args.source, args.baud)
+    else:
+        src = sys.stdin.buffer
+
+    if args.out:
+        os.makedirs(args.out, exist_ok=True)
+    dec = Decoder()
+    for line in read_lines(src, proc):
+        frame = dec.feed(line)
+        if frame is None:
+            continue
+        if args.out:
+            write_png(os.path.join(args.out, "frame_%05d.png" % dec.seq),
+                      frame, args.scale)
+        if args.ascii:
+            sys.stdout.write("\x1b[H\x1b[2J" + ascii_frame(frame) + "\n")
+            sys.stdout.flush()
+        if args.frames and dec.frames >= args.frames:
+            break
+
+    if proc:
+        proc.terminate()
+        proc.wait()
+    print("%d frames (%d key), %d gaps, %d bad" %
+          (dec.frames, dec.keys, dec.gaps, dec.bad), file=sys.stderr)
+    if dec.bad or dec.frames == 0 or (args.frames and
+                                      dec.frames < args.frames):
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
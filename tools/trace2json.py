@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""convert a trace dump from the console log into Chrome trace JSON.
+
+    idf.py -DTRACE=ON flash monitor | tee monitor.log   # see main/trace.h
+    tools/trace2json.py monitor.log > trace.json
+
+open the result in chrome://tracing or https://ui.perfetto.dev. every task
+gets a track with its run slices and a second one with the traced mutex
+waits and holds it did. only the last complete dump in the
+log is converted unless --dump selects another one (0 = first).
+"""
+import argparse
+import json
+import re
+import sys
+
+SWITCH_IN, LOCK_WAIT, LOCK_TAKE, LOCK_GIVE = range(4)
+LINE = re.compile(r"trace,(\w+),?(.*)$")
+
+
+def read_dumps(lines):
+    dumps, cur = [], None
+    for line in lines:
+        m = LINE.search(line.rstrip("\r\n"))
+        if not m:
+            continue
+        kind, rest = m.group(1), m.group(2)
+        if kind == "begin":
+            cur = {"tasks": {}, "locks": {}, "events": []}
+        elif cur is None:
+            continue
+        elif kind == "task":
+            handle, name = rest.split(",", 1)
+            cur["tasks"][int(handle, 16)] = name
+        elif kind == "lock":
+            ptr, name = rest.split(",", 1)
+            cur["locks"][int(ptr, 16)] = name
+        elif kind == "ev":
+            cycles, typ, arg = rest.split(",")
+            cur["events"].append((int(cycles), int(typ), int(arg, 16)))
+        elif kind == "end":
+            cur["mhz"] = int(rest)
+            dumps.append(cur)
+            cur = None
+    return dumps
+
+
+def unwrap(events, mhz):
+    """32 bit cycle stamps -> microseconds from the first event."""
+    total, prev = 0, None
+    for cycles, typ, arg in events:
+        if prev is not None:
+            total += (cycles - prev) & 0xFFFFFFFF
+        prev = cycles
+        yield total / mhz, typ, arg
+
+
+def convert(dump):
+    tids, out = {}, []
+
+    # 락 구간은 실행 구간과 겹치므로 태스크마다 트랙을 하나 더 둠
+    def tid(handle, cat):
+        key = (handle, cat)
+        if key not in tids:
+            tids[key] = len(tids) + 1
+            name = dump["tasks"].get(handle, "task %08x" % handle)
+            if cat == "lock":
+                name += " locks"
+            out.append({"name": "thread_name", "ph": "M", "pid": 1,
+                        "tid": tids[key], "args": {"name": name}})
+        return tids[key]
+
+    def slice_(name, cat, task, start, end):
+        out.append({"name": name, "cat": cat, "ph": "X", "pid": 1,
+                    "tid": tid(task, cat), "ts": start, "dur": end - start})
+
+    running, run_start = None, 0.0
+    waits, holds = {}, {}  # (lock, task) -> start
+    t = 0.0
+    for t, typ, arg in unwrap(dump["events"], dump["mhz"]):
+        if typ == SWITCH_IN:
+            if running is not None and arg != running:
+                name = dump["tasks"].get(running, "task %08x" % running)
+                slice_(name, "sched", running, run_start, t)
+            if arg != running:
+                running, run_start = arg, t
+            continue
+        if running is None:
+            continue  # 링이 돈 직후라 어느 태스크의 이벤트인지 모름
+        lock = dump["locks"].get(arg, "lock %08x" % arg)
+        key = (arg, running)
+        if typ == LOCK_WAIT:
+            waits[key] = t
+        elif typ == LOCK_TAKE:
+            if key in waits:
+                slice_("wait " + lock, "lock", running, waits.pop(key), t)
+            holds[key] = t
+        elif typ == LOCK_GIVE:
+            if key in holds:
+                slice_("hold " + lock, "lock", running, holds.pop(key), t)
+            elif key in waits:
+                slice_("timeout " + lock, "lock", running, waits.pop(key), t)
+    if running is not None:
+        name = dump["tasks"].get(running, "task %08x" % running)
+        slice_(name, "sched", running, run_start, t)
+    return {"traceEvents": out, "displayTimeUnit": "ms"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("log", nargs="?", type=argparse.FileType("r"),
+                        default=sys.stdin)
+    parser.add_argument("--dump", type=int, default=-1)
+    args = parser.parse_args()
+    dumps = read_dumps(args.log)
+    if not dumps:
+        sys.exit("no complete trace dump found")
+    json.dump(convert(dumps[args.dump]), sys.stdout)
+    sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    main()
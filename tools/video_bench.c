@@ -0,0 +1,85 @@
+/*
+ * host benchmark for the video decoder (main/video.c).
+ *
+ *   make video_bench
+ *   ./video_bench in.wfv [loops]
+ *
+ * decodes every frame of the file loops times into one page buffer, the
+ * way the player does, and reports frames/s and the average page rows a
+ * frame touched. the player logs the device numbers after each playback.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "video.h"
+
+#define WIDTH 128
+#define HEIGHT 64
+
+static double now_s(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint8_t *read_file(const char *path, size_t *len) {
+  FILE *f = fopen(path, "rb");
+  if (!f) return NULL;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  uint8_t *buf = malloc(size);
+  if (buf && fread(buf, 1, size, f) != (size_t)size) {
+    free(buf);
+    buf = NULL;
+  }
+  fclose(f);
+  *len = size;
+  return buf;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: video_bench in.wfv [loops]\n");
+    return 2;
+  }
+  int loops = argc > 2 ? atoi(argv[2]) : 200;
+  size_t len;
+  uint8_t *data = read_file(argv[1], &len);
+  if (!data) {
+    perror(argv[1]);
+    return 1;
+  }
+  video_t v;
+  if (video_open(&v, data, len, WIDTH, HEIGHT) != VIDEO_OK) {
+    fprintf(stderr, "%s: not a %dx%d video\n", argv[1], WIDTH, HEIGHT);
+    return 1;
+  }
+
+  uint8_t pages[WIDTH * HEIGHT / 8] = {0};
+  uint64_t frames = 0, dirty_pages = 0;
+  double start = now_s();
+  for (int loop = 0; loop < loops; loop++) {
+    video_rewind(&v);
+    int mask;
+    while ((mask = video_next(&v, pages)) >= 0) {
+      dirty_pages += __builtin_popcount(mask);
+      frames++;
+    }
+    if (mask != VIDEO_ERR_END) {
+      fprintf(stderr, "frame %u is corrupt\n", (unsigned)v.frame);
+      return 1;
+    }
+  }
+  double elapsed = now_s() - start;
+
+  printf("%s: %u frames, %u bytes, %.0f bytes/frame\n", argv[1],
+         (unsigned)v.info.frame_count, (unsigned)v.info.data_size,
+         (double)v.info.data_size / v.info.frame_count);
+  printf("decode: %.0f frames/s, %.2f us/frame, %.1f of %d pages dirty\n",
+         frames / elapsed, elapsed * 1e6 / frames,
+         (double)dirty_pages / frames, HEIGHT / 8);
+  free(data);
+  return 0;
+}
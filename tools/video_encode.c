@@ -0,0 +1,155 @@
+/*
+ * encodes 1bpp frames into the container the player reads from the video
+ * partition (main/video.h).
+ *
+ *   make video_encode
+ *   ./video_encode [-r fps] [-k key_interval] [-i] out.wfv in.pbm...
+ *
+ * inputs are binary PBMs (P4) of 128 pixel wide frames, a taller image is
+ * cut into 64 row frames, so sim/ssd1306_sim -f pbm output and the stacked
+ * golden/frames.pbm both work. integer upscaled images (-s of the sim) are
+ * sampled back down. white is a lit pixel like on the panel, -i swaps it.
+ * the result is decoded again and compared before it is written.
+ */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "video.h"
+
+#define WIDTH 128
+#define HEIGHT 64
+#define PAGE_BYTES (WIDTH * HEIGHT / 8)
+
+typedef struct {
+  uint8_t *pages;  // all frames back to back in page layout
+  uint32_t count;
+  uint32_t cap;
+} frames_t;
+
+static bool read_pbm(const char *path, bool invert, frames_t *frames) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return false;
+  }
+  int w, h;
+  if (fscanf(f, "P4 %d %d", &w, &h) != 2 || fgetc(f) == EOF || w <= 0 ||
+      w % WIDTH || h % (HEIGHT * (w / WIDTH))) {
+    fprintf(stderr, "%s: not a P4 PBM of %dx%d frames\n", path, WIDTH,
+            HEIGHT);
+    fclose(f);
+    return false;
+  }
+  int scale = w / WIDTH;
+  int stride = (w + 7) / 8;
+  uint8_t *img = malloc((size_t)stride * h);
+  bool ok = img && fread(img, stride, h, f) == (size_t)h;
+  fclose(f);
+  if (!ok) {
+    fprintf(stderr, "%s: truncated\n", path);
+    free(img);
+    return false;
+  }
+
+  uint32_t n = h / (HEIGHT * scale);
+  if (frames->count + n > frames->cap) {
+    frames->cap = (frames->count + n) * 2;
+    frames->pages = realloc(frames->pages, (size_t)frames->cap * PAGE_BYTES);
+    if (!frames->pages) abort();
+  }
+  for (uint32_t i = 0; i < n; i++) {
+    uint8_t *pages = frames->pages + (size_t)(frames->count + i) * PAGE_BYTES;
+    memset(pages, 0, PAGE_BYTES);
+    for (int y = 0; y < HEIGHT; y++) {
+      const uint8_t *row = img + (size_t)((i * HEIGHT + y) * scale) * stride;
+      for (int x = 0; x < WIDTH; x++) {
+        // PBM은 1이 검정, 패널에서는 흰 픽셀이 켜진 픽셀
+        bool black = row[x * scale / 8] >> (7 - x * scale % 8) & 1;
+        if (black == invert) pages[WIDTH * (y / 8) + x] |= 1 << (y % 8);
+      }
+    }
+  }
+  frames->count += n;
+  free(img);
+  return true;
+}
+
+static int usage(void) {
+  fprintf(stderr,
+          "usage: video_encode [-r fps] [-k key_interval] [-i] out.wfv "
+          "in.pbm...\n");
+  return 2;
+}
+
+int main(int argc, char **argv) {
+  int fps = VIDEO_DEFAULT_FPS, key_interval = VIDEO_DEFAULT_KEY_INTERVAL;
+  bool invert = false;
+  int c;
+  while ((c = getopt(argc, argv, "r:k:i")) != -1) {
+    switch (c) {
+      case 'r':
+        fps = atoi(optarg);
+        break;
+      case 'k':
+        key_interval = atoi(optarg);
+        break;
+      case 'i':
+        invert = true;
+        break;
+      default:
+        return usage();
+    }
+  }
+  if (argc - optind < 2 || fps < 1 || key_interval < 1) return usage();
+
+  frames_t frames = {0};
+  for (int i = optind + 1; i < argc; i++)
+    if (!read_pbm(argv[i], invert, &frames)) return 1;
+  if (frames.count == 0) {
+    fprintf(stderr, "no frames\n");
+    return 1;
+  }
+
+  video_encoder_t enc;
+  if (!video_encoder_init(&enc, WIDTH, HEIGHT, fps, key_interval)) return 1;
+  size_t max = VIDEO_HEADER_SIZE + frames.count * video_frame_max_size(&enc);
+  uint8_t *out = malloc(max);
+  if (!out) return 1;
+  size_t size = VIDEO_HEADER_SIZE;
+  for (uint32_t i = 0; i < frames.count; i++)
+    size += video_encode_frame(&enc, frames.pages + (size_t)i * PAGE_BYTES,
+                               out + size);
+  video_write_header(&enc, out);
+
+  // 플레이어와 같은 디코더로 되돌려 비교
+  video_t v;
+  uint8_t pages[PAGE_BYTES] = {0};
+  if (video_open(&v, out, size, WIDTH, HEIGHT) != VIDEO_OK) {
+    fprintf(stderr, "encoded header does not parse\n");
+    return 1;
+  }
+  for (uint32_t i = 0; i < frames.count; i++) {
+    if (video_next(&v, pages) < 0 ||
+        memcmp(pages, frames.pages + (size_t)i * PAGE_BYTES, PAGE_BYTES)) {
+      fprintf(stderr, "frame %u does not decode back\n", (unsigned)i);
+      return 1;
+    }
+  }
+
+  FILE *f = fopen(argv[optind], "wb");
+  if (!f || fwrite(out, 1, size, f) != size || fclose(f) != 0) {
+    perror(argv[optind]);
+    return 1;
+  }
+  printf("%s: %u frames at %d fps, %zu bytes (%.1f%% of raw, %zu per frame)\n",
+         argv[optind], (unsigned)frames.count, fps, size,
+         100.0 * size / ((size_t)frames.count * PAGE_BYTES),
+         size / frames.count);
+  video_encoder_free(&enc);
+  free(out);
+  free(frames.pages);
+  return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * host benchmark for the batched projection kernel (main/xform.c).
+ *
+ *   make xform_bench      # xform.c with the firmware's -O3
+ *   ./xform_bench [vertices] [iterations]
+ *
+ * reports vertices/s for the SoA kernel and for the old AoS loop it
+ * replaced. on the device set RENDER_XFORM_BENCH in render.h instead.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "xform.h"
+
+static double now_s(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// render.c 의 이전 방식: AoS 정점을 하나씩 변환
+static void project_aos(const mat34_t *m, const vec3_t *v, int count,
+                        float near, int16_t *out) {
+  for (int i = 0; i < count; i++) {
+    vec3_t p = mat34_apply(m, &v[i]);
+    if (p.z < near) {
+      out[2 * i] = XFORM_CLIPPED;
+      continue;
+    }
+    out[2 * i] = (int16_t)(p.x / p.z);
+    out[2 * i + 1] = (int16_t)(p.y / p.z);
+  }
+}
+
+int main(int argc, char **argv) {
+  int count = argc > 1 ? atoi(argv[1]) : 1024;
+  int iterations = argc > 2 ? atoi(argv[2]) : 20000;
+
+  vertex_soa_t soa = {
+      .x = malloc(count * sizeof(float)),
+      .y = malloc(count * sizeof(float)),
+      .z = malloc(count * sizeof(float)),
+      .count = count,
+  };
+  vec3_t *aos = malloc(count * sizeof(vec3_t));
+  int16_t *out = malloc(count * 2 * sizeof(int16_t));
+  if (!soa.x || !soa.y || !soa.z || !aos || !out) return 1;
+
+  for (int i = 0; i < count; i++) {
+    vec3_t v = {(i % 32) / 16.0f - 1, (i / 32 % 32) / 16.0f - 1,
+                (i % 7) / 7.0f};
+    vertex_soa_set(&soa, i, v);
+    aos[i] = v;
+  }
+  // 128x64, 수평 75도 카메라를 z = -8에 둔 것과 같은 투영
+  const mat34_t m = {{{83.4f, 0, 64, 512}, {0, -83.4f, 32, 256}, {0, 0, 1, 8}}};
+
+  long checksum = 0;
+  double start = now_s();
+  for (int i = 0; i < iterations; i++) {
+    xform_project(&m, soa.x, soa.y, soa.z, soa.count, 0.1f, out);
+    checksum += out[i % (count * 2)];
+  }
+  double soa_s = now_s() - start;
+
+  start = now_s();
+  for (int i = 0; i < iterations; i++) {
+    project_aos(&m, aos, count, 0.1f, out);
+    checksum += out[i % (count * 2)];
+  }
+  double aos_s = now_s() - start;
+
+  double total = (double)count * iterations;
+  printf("vertices: %d, iterations: %d (checksum %ld)\n", count, iterations,
+         checksum);
+  printf("soa kernel: %.1f Mvertices/s\n", total / soa_s / 1e6);
+  printf("aos loop:   %.1f Mvertices/s\n", total / aos_s / 1e6);
+  return 0;
+}